@@ -28,3 +28,4 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "Splashentation/Standard.hpp"
+#include "Splashentation/SdfText.hpp"
@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef SPLASHENTATION_CONTENTIONTRACKINGMUTEX_HPP
+#define SPLASHENTATION_CONTENTIONTRACKINGMUTEX_HPP
+
+#include "Standard.hpp"
+#include "SteadyTime.hpp"
+
+// mutex that counts acquisitions, contended locks and the time spent waiting for them
+class Splashentation::ContentionTrackingMutex
+{
+public:
+	void lock()
+	{
+		m_acquisitions.fetch_add(1u, std::memory_order_relaxed);
+		if (m_mutex.try_lock())
+			return;
+		const sf::Int64 waitStart{ SplashentationInternal::getSteadyTimeInMicroseconds() };
+		m_mutex.lock();
+		const sf::Int64 wait{ SplashentationInternal::getSteadyTimeInMicroseconds() - waitStart };
+		++m_contentions;
+		m_totalWait += wait;
+		if (wait > m_maximumWait)
+			m_maximumWait = wait;
+	}
+	bool try_lock()
+	{
+		if (!m_mutex.try_lock())
+			return false;
+		m_acquisitions.fetch_add(1u, std::memory_order_relaxed);
+		return true;
+	}
+	void unlock() { m_mutex.unlock(); }
+	LockContention getContention() const
+	{
+		LockContention contention;
+		contention.acquisitions = m_acquisitions;
+		contention.contentions = m_contentions;
+		contention.totalWait = sf::microseconds(m_totalWait);
+		contention.maximumWait = sf::microseconds(m_maximumWait);
+		return contention;
+	}
+	void resetContention()
+	{
+		m_acquisitions = 0u;
+		m_contentions = 0u;
+		m_totalWait = 0;
+		m_maximumWait = 0;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::atomic<sf::Uint64> m_acquisitions{ 0u };
+	std::atomic<sf::Uint64> m_contentions{ 0u };
+	std::atomic<sf::Int64> m_totalWait{ 0 }; // microseconds
+	std::atomic<sf::Int64> m_maximumWait{ 0 }; // microseconds
+};
+
+#endif // SPLASHENTATION_CONTENTIONTRACKINGMUTEX_HPP
@@ -0,0 +1,428 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include "FramePreparer.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+
+// batches are passed as a template parameter so that these helpers do not need to name the (private) preparer type
+template <class batchesT>
+void addVertices(batchesT& batches, const sf::Texture* texture, const std::vector<sf::Vertex>& vertices)
+{
+	if (vertices.empty())
+		return;
+	if (batches.empty() || (batches.back().unpreparedDrawable != nullptr) || (batches.back().texture != texture))
+		batches.push_back({ texture, std::vector<sf::Vertex>(), nullptr });
+	std::vector<sf::Vertex>& batchVertices{ batches.back().vertices };
+	batchVertices.insert(batchVertices.end(), vertices.begin(), vertices.end());
+}
+
+template <class batchesT>
+void addUnpreparedDrawable(batchesT& batches, const sf::Drawable& drawable)
+{
+	batches.push_back({ nullptr, std::vector<sf::Vertex>(), &drawable });
+}
+
+void appendStripAsTriangles(std::vector<sf::Vertex>& triangles, const sf::Vertex* strip, const std::size_t count)
+{
+	for (std::size_t i{ 2u }; i < count; ++i)
+	{
+		triangles.push_back(strip[i - 2u]);
+		triangles.push_back(strip[i - 1u]);
+		triangles.push_back(strip[i]);
+	}
+}
+
+void appendFanAsTriangles(std::vector<sf::Vertex>& triangles, const sf::Vertex* fan, const std::size_t count)
+{
+	for (std::size_t i{ 2u }; i < count; ++i)
+	{
+		triangles.push_back(fan[0u]);
+		triangles.push_back(fan[i - 1u]);
+		triangles.push_back(fan[i]);
+	}
+}
+
+void transformVertices(std::vector<sf::Vertex>& vertices, const sf::Transform& transform)
+{
+	for (auto& vertex : vertices)
+		vertex.position = transform.transformPoint(vertex.position);
+}
+
+template <class batchesT>
+void prepareSprite(batchesT& batches, const sf::Sprite& sprite)
+{
+	if (sprite.getTexture() == nullptr)
+		return;
+
+	// matches sf::Sprite's own geometry
+	const sf::IntRect textureRect{ sprite.getTextureRect() };
+	const sf::FloatRect bounds{ sprite.getLocalBounds() };
+	const float left{ static_cast<float>(textureRect.left) };
+	const float right{ left + textureRect.width };
+	const float top{ static_cast<float>(textureRect.top) };
+	const float bottom{ top + textureRect.height };
+	const sf::Vertex strip[4]
+	{
+		sf::Vertex({ 0.f, 0.f }, sprite.getColor(), { left, top }),
+		sf::Vertex({ 0.f, bounds.height }, sprite.getColor(), { left, bottom }),
+		sf::Vertex({ bounds.width, 0.f }, sprite.getColor(), { right, top }),
+		sf::Vertex({ bounds.width, bounds.height }, sprite.getColor(), { right, bottom }),
+	};
+	std::vector<sf::Vertex> triangles;
+	triangles.reserve(6u);
+	appendStripAsTriangles(triangles, strip, 4u);
+	transformVertices(triangles, sprite.getTransform());
+	addVertices(batches, sprite.getTexture(), triangles);
+}
+
+sf::Vector2f computeNormal(const sf::Vector2f& p1, const sf::Vector2f& p2)
+{
+	sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+	const float length{ std::sqrt(normal.x * normal.x + normal.y * normal.y) };
+	if (length != 0.f)
+		normal = normal / length;
+	return normal;
+}
+
+template <class batchesT>
+void prepareShape(batchesT& batches, const sf::Shape& shape)
+{
+	// matches sf::Shape's own geometry (fill as a fan around the centre of the points, outline as a strip)
+	const std::size_t count{ shape.getPointCount() };
+	if (count < 3u)
+		return;
+
+	std::vector<sf::Vector2f> points(count);
+	sf::FloatRect insideBounds;
+	for (std::size_t i{ 0u }; i < count; ++i)
+		points[i] = shape.getPoint(i);
+	float minimumX{ points[0u].x }, maximumX{ points[0u].x }, minimumY{ points[0u].y }, maximumY{ points[0u].y };
+	for (auto& point : points)
+	{
+		minimumX = std::min(minimumX, point.x);
+		maximumX = std::max(maximumX, point.x);
+		minimumY = std::min(minimumY, point.y);
+		maximumY = std::max(maximumY, point.y);
+	}
+	insideBounds = { minimumX, minimumY, maximumX - minimumX, maximumY - minimumY };
+	const sf::Vector2f centre(insideBounds.left + insideBounds.width / 2.f, insideBounds.top + insideBounds.height / 2.f);
+	const sf::IntRect textureRect{ shape.getTextureRect() };
+	const sf::Color fillColor{ shape.getFillColor() };
+	const sf::Transform& transform{ shape.getTransform() };
+
+	auto getTexCoords = [&](const sf::Vector2f& point)
+	{
+		const float xRatio{ (insideBounds.width > 0.f) ? (point.x - insideBounds.left) / insideBounds.width : 0.f };
+		const float yRatio{ (insideBounds.height > 0.f) ? (point.y - insideBounds.top) / insideBounds.height : 0.f };
+		return sf::Vector2f(textureRect.left + textureRect.width * xRatio, textureRect.top + textureRect.height * yRatio);
+	};
+
+	std::vector<sf::Vertex> fan;
+	fan.reserve(count + 2u);
+	fan.emplace_back(centre, fillColor, getTexCoords(centre));
+	for (std::size_t i{ 0u }; i <= count; ++i)
+		fan.emplace_back(points[i % count], fillColor, getTexCoords(points[i % count]));
+	std::vector<sf::Vertex> triangles;
+	triangles.reserve(count * 3u);
+	appendFanAsTriangles(triangles, fan.data(), fan.size());
+	transformVertices(triangles, transform);
+	addVertices(batches, shape.getTexture(), triangles);
+
+	const float thickness{ shape.getOutlineThickness() };
+	if (thickness == 0.f)
+		return;
+
+	const sf::Color outlineColor{ shape.getOutlineColor() };
+	std::vector<sf::Vertex> strip;
+	strip.reserve((count + 1u) * 2u);
+	for (std::size_t i{ 0u }; i <= count; ++i)
+	{
+		const std::size_t index{ (i < count) ? i : 0u };
+		const sf::Vector2f p0{ points[(index == 0u) ? count - 1u : index - 1u] };
+		const sf::Vector2f p1{ points[index] };
+		const sf::Vector2f p2{ points[(index + 1u) % count] };
+		sf::Vector2f n1{ computeNormal(p0, p1) };
+		sf::Vector2f n2{ computeNormal(p1, p2) };
+
+		// normals must point outwards (which depends on the order of the points)
+		const sf::Vector2f towardsCentre{ centre - p1 };
+		if ((n1.x * towardsCentre.x + n1.y * towardsCentre.y) > 0.f)
+			n1 = sf::Vector2f(-n1.x, -n1.y);
+		if ((n2.x * towardsCentre.x + n2.y * towardsCentre.y) > 0.f)
+			n2 = sf::Vector2f(-n2.x, -n2.y);
+
+		const float factor{ 1.f + (n1.x * n2.x + n1.y * n2.y) };
+		const sf::Vector2f normal{ (n1 + n2) / factor };
+		strip.emplace_back(p1, outlineColor);
+		strip.emplace_back(p1 + normal * thickness, outlineColor);
+	}
+	triangles.clear();
+	appendStripAsTriangles(triangles, strip.data(), strip.size());
+	transformVertices(triangles, transform);
+	addVertices(batches, nullptr, triangles);
+}
+
+template <class batchesT>
+bool prepareVertexArray(batchesT& batches, const sf::VertexArray& vertexArray)
+{
+	const std::size_t count{ vertexArray.getVertexCount() };
+	if (count == 0u)
+		return true;
+
+	std::vector<sf::Vertex> vertices(count);
+	for (std::size_t i{ 0u }; i < count; ++i)
+		vertices[i] = vertexArray[i];
+	std::vector<sf::Vertex> triangles;
+	switch (vertexArray.getPrimitiveType())
+	{
+	case sf::Triangles:
+		triangles.swap(vertices);
+		triangles.resize(count - (count % 3u));
+		break;
+	case sf::TriangleStrip:
+		appendStripAsTriangles(triangles, vertices.data(), count);
+		break;
+	case sf::TriangleFan:
+		appendFanAsTriangles(triangles, vertices.data(), count);
+		break;
+	case sf::Quads:
+		for (std::size_t i{ 3u }; i < count; i += 4u)
+		{
+			const sf::Vertex* quad{ vertices.data() + i - 3u };
+			const sf::Vertex fan[4]{ quad[0u], quad[1u], quad[2u], quad[3u] };
+			appendFanAsTriangles(triangles, fan, 4u);
+		}
+		break;
+	default:
+		return false; // points and lines cannot be batched with triangles
+	}
+	addVertices(batches, nullptr, triangles);
+	return true;
+}
+
+template <class batchesT>
+void prepareDrawable(batchesT& batches, const sf::Drawable& drawable)
+{
+	if (const sf::Sprite* sprite = dynamic_cast<const sf::Sprite*>(&drawable))
+		prepareSprite(batches, *sprite);
+	else if (const sf::Shape* shape = dynamic_cast<const sf::Shape*>(&drawable))
+		prepareShape(batches, *shape);
+	else if (const sf::VertexArray* vertexArray = dynamic_cast<const sf::VertexArray*>(&drawable))
+	{
+		if (!prepareVertexArray(batches, *vertexArray))
+			addUnpreparedDrawable(batches, drawable);
+	}
+	else
+		addUnpreparedDrawable(batches, drawable);
+}
+
+} // namespace
+
+Splashentation::FramePreparer::FramePreparer(const std::size_t numberOfWorkers, const std::function<void()>& threadSetup)
+	: m_threadSetup(threadSetup)
+	, m_workers()
+	, m_jobGeneration(0u)
+	, m_isStopping(false)
+	, m_drawables(nullptr)
+	, m_chunkBatches()
+	, m_chunkSize(1u)
+	, m_numberOfChunks(0u)
+	, m_completedChunks(0u)
+	, m_nextChunk(0u)
+	, m_isBackgroundBusy(false)
+{
+	for (std::size_t i{ 0u }; i < numberOfWorkers; ++i)
+		m_workers.emplace_back(&FramePreparer::t_work, this);
+	m_backgroundThread = std::thread(&FramePreparer::t_background, this);
+}
+
+Splashentation::FramePreparer::~FramePreparer()
+{
+	waitForBackground();
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		m_isStopping = true;
+	}
+	m_jobCondition.notify_all();
+	{
+		std::lock_guard<std::mutex> lockGuard(m_backgroundMutex);
+		m_backgroundCondition.notify_all();
+	}
+	for (auto& worker : m_workers)
+		worker.join();
+	m_backgroundThread.join();
+}
+
+void Splashentation::FramePreparer::prepare(const std::vector<const sf::Drawable*>& drawables, Batches& batches)
+{
+	batches.clear();
+	if (drawables.empty())
+		return;
+
+	// a few chunks per thread helps balance drawables of differing complexity
+	const std::size_t targetNumberOfChunks{ std::min(drawables.size(), (m_workers.size() + 1u) * 4u) };
+	m_drawables = &drawables;
+	m_chunkSize = (drawables.size() + targetNumberOfChunks - 1u) / targetNumberOfChunks;
+	const std::size_t numberOfChunks{ (drawables.size() + m_chunkSize - 1u) / m_chunkSize };
+	m_chunkBatches.resize(numberOfChunks);
+	for (auto& chunkBatches : m_chunkBatches)
+		chunkBatches.clear();
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		m_completedChunks = 0u;
+		m_numberOfChunks = numberOfChunks;
+		m_nextChunk = 0u;
+		++m_jobGeneration;
+	}
+	m_jobCondition.notify_all();
+
+	priv_processChunks();
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_completeCondition.wait(lock, [this] { return m_completedChunks == m_numberOfChunks; });
+	}
+
+	// join chunks in order, merging batches that continue across chunk boundaries
+	for (auto& chunkBatches : m_chunkBatches)
+	{
+		for (auto& batch : chunkBatches)
+		{
+			if ((batch.unpreparedDrawable == nullptr) && (!batches.empty()) && (batches.back().unpreparedDrawable == nullptr) && (batches.back().texture == batch.texture))
+				batches.back().vertices.insert(batches.back().vertices.end(), batch.vertices.begin(), batch.vertices.end());
+			else
+				batches.push_back(std::move(batch));
+		}
+	}
+	m_drawables = nullptr;
+}
+
+void Splashentation::FramePreparer::runInBackground(const std::function<void()>& job)
+{
+	waitForBackground();
+	{
+		std::lock_guard<std::mutex> lockGuard(m_backgroundMutex);
+		m_backgroundJob = job;
+		m_isBackgroundBusy = true;
+	}
+	m_backgroundCondition.notify_all();
+}
+
+void Splashentation::FramePreparer::waitForBackground()
+{
+	std::unique_lock<std::mutex> lock(m_backgroundMutex);
+	m_backgroundCondition.wait(lock, [this] { return !m_isBackgroundBusy; });
+}
+
+void Splashentation::FramePreparer::draw(sf::RenderTarget& target, const Batches& batches)
+{
+	for (auto& batch : batches)
+	{
+		if (batch.unpreparedDrawable != nullptr)
+			target.draw(*batch.unpreparedDrawable);
+		else
+			target.draw(batch.vertices.data(), batch.vertices.size(), sf::Triangles, sf::RenderStates(batch.texture));
+	}
+}
+
+
+
+// PRIVATE
+
+void Splashentation::FramePreparer::t_work()
+{
+	if (m_threadSetup)
+		m_threadSetup();
+	unsigned int seenJobGeneration{ 0u };
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobCondition.wait(lock, [&] { return m_isStopping || (m_jobGeneration != seenJobGeneration); });
+			if (m_isStopping)
+				return;
+			seenJobGeneration = m_jobGeneration;
+		}
+		priv_processChunks();
+	}
+}
+
+void Splashentation::FramePreparer::t_background()
+{
+	if (m_threadSetup)
+		m_threadSetup();
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_backgroundMutex);
+			m_backgroundCondition.wait(lock, [this] { return m_isBackgroundBusy || m_isStopping; });
+			if (!m_isBackgroundBusy)
+				return;
+			job.swap(m_backgroundJob);
+		}
+		job();
+		{
+			std::lock_guard<std::mutex> lockGuard(m_backgroundMutex);
+			m_isBackgroundBusy = false;
+		}
+		m_backgroundCondition.notify_all();
+	}
+}
+
+void Splashentation::FramePreparer::priv_processChunks()
+{
+	// chunks are few (a handful per thread) so claiming them under the lock costs little
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_nextChunk < m_numberOfChunks)
+	{
+		const std::size_t chunk{ m_nextChunk++ };
+		lock.unlock();
+
+		const std::vector<const sf::Drawable*>& drawables{ *m_drawables };
+		const std::size_t end{ std::min((chunk + 1u) * m_chunkSize, drawables.size()) };
+		for (std::size_t i{ chunk * m_chunkSize }; i < end; ++i)
+			prepareDrawable(m_chunkBatches[chunk], *drawables[i]);
+
+		lock.lock();
+		if (++m_completedChunks == m_numberOfChunks)
+			m_completeCondition.notify_all();
+	}
+}
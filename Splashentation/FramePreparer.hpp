@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SPLASHENTATION_FRAMEPREPARER_HPP
+#define SPLASHENTATION_FRAMEPREPARER_HPP
+
+#include "Standard.hpp"
+
+#include <SFML/Graphics/Vertex.hpp>
+
+namespace sf
+{
+
+class RenderTarget;
+class Texture;
+
+} // namespace sf
+
+// converts drawables into transformed, texture-batched triangles using a pool of worker threads.
+// sprites, shapes and vertex arrays (of triangle-based primitives) are prepared; anything else is drawn directly, keeping its place in the order.
+class Splashentation::FramePreparer
+{
+public:
+	struct Batch
+	{
+		const sf::Texture* texture;
+		std::vector<sf::Vertex> vertices; // triangles in global coordinates
+		const sf::Drawable* unpreparedDrawable; // if not nullptr, this drawable is drawn directly instead of the vertices
+	};
+	typedef std::vector<Batch> Batches;
+
+	FramePreparer(std::size_t numberOfWorkers, const std::function<void()>& threadSetup = nullptr); // thread setup is run at the start of each of its threads
+	~FramePreparer();
+
+	void prepare(const std::vector<const sf::Drawable*>& drawables, Batches& batches); // blocks until complete; the calling thread also takes part
+	void runInBackground(const std::function<void()>& job);
+	void waitForBackground();
+	static void draw(sf::RenderTarget& target, const Batches& batches);
+
+private:
+	const std::function<void()> m_threadSetup;
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_jobCondition;
+	std::condition_variable m_completeCondition;
+	unsigned int m_jobGeneration;
+	std::atomic<bool> m_isStopping; // also read by the background thread (under m_backgroundMutex)
+
+	// current job (chunk counters are guarded by m_mutex)
+	const std::vector<const sf::Drawable*>* m_drawables;
+	std::vector<Batches> m_chunkBatches;
+	std::size_t m_chunkSize;
+	std::size_t m_numberOfChunks;
+	std::size_t m_completedChunks;
+	std::size_t m_nextChunk;
+
+	// background job
+	std::thread m_backgroundThread;
+	std::mutex m_backgroundMutex;
+	std::condition_variable m_backgroundCondition;
+	std::function<void()> m_backgroundJob;
+	bool m_isBackgroundBusy;
+
+	void t_work();
+	void t_background();
+
+	void priv_processChunks();
+};
+
+#endif // SPLASHENTATION_FRAMEPREPARER_HPP
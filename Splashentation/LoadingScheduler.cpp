@@ -0,0 +1,374 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include "LoadingScheduler.hpp"
+#include "SteadyTime.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+const float weightScale{ 1024.f };
+
+using SplashentationInternal::getSteadyTimeInMicroseconds;
+
+} // namespace
+
+Splashentation::LoadingScheduler::LoadingScheduler()
+	: m_tasks()
+	, m_workers()
+	, m_threads()
+	, m_totalTasks(0u)
+	, m_totalWeight(0u)
+	, m_queuedTasks(0u)
+	, m_completedTasks(0u)
+	, m_failedTasks(0u)
+	, m_completedWeight(0u)
+	, m_isStarted(false)
+	, m_isCancelled(false)
+	, m_isFinished(false)
+	, m_startTime(0)
+	, m_completeTime(0)
+	, m_backgroundTasks()
+	, m_backgroundThread()
+	, m_isBackgroundThreadRunning(false)
+	, m_backgroundThreadSetup()
+{
+}
+
+Splashentation::LoadingScheduler::~LoadingScheduler()
+{
+	cancel();
+	wait();
+	if (m_backgroundThread.joinable())
+		m_backgroundThread.join();
+}
+
+Splashentation::LoadingTaskId Splashentation::LoadingScheduler::addTask(const std::function<void()>& function, const float weight, const std::vector<LoadingTaskId>& dependencies)
+{
+	// tasks cannot be added once started
+	assert(!m_isStarted);
+
+	const LoadingTaskId taskId{ m_tasks.size() };
+	std::unique_ptr<Task> task(new Task);
+	task->function = function;
+	task->weight = static_cast<sf::Uint64>(std::max(weight, 0.f) * weightScale);
+	task->numberOfDependencies = 0u;
+	for (auto& dependency : dependencies)
+	{
+		// dependencies must already exist (this also prevents cycles)
+		assert(dependency < taskId);
+
+		m_tasks[dependency]->dependents.push_back(taskId);
+		++task->numberOfDependencies;
+	}
+	task->remainingDependencies = task->numberOfDependencies;
+	m_totalWeight += task->weight;
+	m_tasks.push_back(std::move(task));
+	++m_totalTasks;
+	return taskId;
+}
+
+void Splashentation::LoadingScheduler::clearTasks()
+{
+	wait();
+	m_isStarted = false;
+	m_isFinished = false;
+	m_totalTasks = 0u;
+	m_totalWeight = 0u;
+	m_tasks.clear();
+	m_workers.clear();
+	m_queuedTasks = 0u;
+	m_completedTasks = 0u;
+	m_failedTasks = 0u;
+	m_completedWeight = 0u;
+	m_isCancelled = false;
+}
+
+void Splashentation::LoadingScheduler::start()
+{
+	if (m_isStarted)
+		return;
+
+	// one core is left for the render thread
+	const unsigned int numberOfCores{ std::thread::hardware_concurrency() };
+	const std::size_t numberOfWorkers{ std::max(std::min<std::size_t>((numberOfCores > 1u) ? numberOfCores - 1u : 1u, m_tasks.size()), static_cast<std::size_t>(1u)) };
+
+	m_workers.clear();
+	for (std::size_t i{ 0u }; i < numberOfWorkers; ++i)
+		m_workers.emplace_back(new Worker);
+
+	m_startTime = getSteadyTimeInMicroseconds();
+	m_completeTime = m_startTime.load();
+	m_isFinished = m_tasks.empty();
+	m_isStarted = true;
+
+	// distribute initially-ready tasks across workers
+	std::size_t workerIndex{ 0u };
+	for (LoadingTaskId taskId{ 0u }; taskId < m_tasks.size(); ++taskId)
+	{
+		if (m_tasks[taskId]->numberOfDependencies == 0u)
+		{
+			priv_push(workerIndex, taskId);
+			workerIndex = (workerIndex + 1u) % numberOfWorkers;
+		}
+	}
+
+	for (std::size_t i{ 0u }; i < numberOfWorkers; ++i)
+		m_threads.emplace_back(&LoadingScheduler::t_work, this, i);
+}
+
+void Splashentation::LoadingScheduler::cancel()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_sleepMutex);
+		m_isCancelled = true;
+	}
+	m_sleepCondition.notify_all();
+}
+
+void Splashentation::LoadingScheduler::wait()
+{
+	for (auto& thread : m_threads)
+	{
+		if (thread.joinable())
+			thread.join();
+	}
+	m_threads.clear();
+}
+
+bool Splashentation::LoadingScheduler::isStarted() const
+{
+	return m_isStarted;
+}
+
+bool Splashentation::LoadingScheduler::isCancelled() const
+{
+	return m_isCancelled;
+}
+
+bool Splashentation::LoadingScheduler::isComplete() const
+{
+	return m_isStarted && priv_isFinished();
+}
+
+Splashentation::LoadingProgress Splashentation::LoadingScheduler::getProgress() const
+{
+	LoadingProgress progress;
+	progress.totalTasks = m_totalTasks;
+	progress.completedTasks = m_completedTasks;
+	progress.failedTasks = m_failedTasks;
+	progress.isComplete = isComplete();
+	progress.isCancelled = m_isCancelled;
+	if (!m_isStarted)
+		return progress;
+
+	const sf::Uint64 completedWeight{ m_completedWeight };
+	progress.ratio = (m_totalWeight == 0u) ? (progress.isComplete ? 1.f : 0.f) : static_cast<float>(static_cast<double>(completedWeight) / m_totalWeight);
+	progress.elapsed = sf::microseconds((progress.isComplete ? m_completeTime.load() : getSteadyTimeInMicroseconds()) - m_startTime);
+	const float elapsedSeconds{ progress.elapsed.asSeconds() };
+	if (elapsedSeconds > 0.f)
+		progress.tasksPerSecond = progress.completedTasks / elapsedSeconds;
+	if ((progress.ratio > 0.f) && (!progress.isComplete))
+		progress.estimatedRemaining = sf::seconds(elapsedSeconds * (1.f - progress.ratio) / progress.ratio);
+	return progress;
+}
+void Splashentation::LoadingScheduler::addBackgroundTask(const std::function<void()>& function)
+{
+	std::unique_lock<std::mutex> sleepLock(m_sleepMutex);
+	m_backgroundTasks.push_back(function);
+	if (!m_isBackgroundThreadRunning)
+	{
+		// a previous background thread has already left its loop
+		if (m_backgroundThread.joinable())
+			m_backgroundThread.join();
+		m_isBackgroundThreadRunning = true;
+		m_backgroundThread = std::thread(&LoadingScheduler::t_runBackgroundTasks, this);
+	}
+	sleepLock.unlock();
+	m_sleepCondition.notify_all();
+}
+
+void Splashentation::LoadingScheduler::setBackgroundThreadSetup(const std::function<void()>& function)
+{
+	std::lock_guard<std::mutex> lockGuard(m_sleepMutex);
+	m_backgroundThreadSetup = function;
+}
+
+
+
+// PRIVATE
+
+void Splashentation::LoadingScheduler::t_work(const std::size_t workerIndex)
+{
+	while (true)
+	{
+		LoadingTaskId taskId;
+		if (priv_pop(workerIndex, taskId))
+		{
+			priv_run(workerIndex, taskId);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> sleepLock(m_sleepMutex);
+		m_sleepCondition.wait(sleepLock, [this] { return (m_queuedTasks > 0u) || (!m_backgroundTasks.empty()) || (m_isCancelled) || (priv_isFinished()); });
+		if ((m_isCancelled) || (priv_isFinished()))
+			return;
+
+		// an idle worker helps with background tasks
+		std::function<void()> function;
+		if ((m_queuedTasks == 0u) && (priv_popBackgroundTask(function)))
+		{
+			sleepLock.unlock();
+			priv_runBackgroundTask(function);
+		}
+	}
+}
+
+void Splashentation::LoadingScheduler::t_runBackgroundTasks()
+{
+	std::unique_lock<std::mutex> sleepLock(m_sleepMutex);
+	if (m_backgroundThreadSetup)
+	{
+		const std::function<void()> threadSetup{ m_backgroundThreadSetup };
+		sleepLock.unlock();
+		threadSetup();
+		sleepLock.lock();
+	}
+	std::function<void()> function;
+	while (priv_popBackgroundTask(function))
+	{
+		sleepLock.unlock();
+		priv_runBackgroundTask(function);
+		sleepLock.lock();
+	}
+	m_isBackgroundThreadRunning = false;
+}
+
+void Splashentation::LoadingScheduler::priv_push(const std::size_t workerIndex, const LoadingTaskId taskId)
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_workers[workerIndex]->mutex);
+		m_workers[workerIndex]->queue.push_back(taskId);
+	}
+	{
+		std::lock_guard<std::mutex> lockGuard(m_sleepMutex);
+		++m_queuedTasks;
+	}
+	m_sleepCondition.notify_one();
+}
+
+bool Splashentation::LoadingScheduler::priv_pop(const std::size_t workerIndex, LoadingTaskId& taskId)
+{
+	// own queue first (newest first, for locality) then steal from the others (oldest first)
+	for (std::size_t i{ 0u }; i < m_workers.size(); ++i)
+	{
+		const bool isOwnQueue{ i == 0u };
+		Worker& worker{ *m_workers[(workerIndex + i) % m_workers.size()] };
+		std::lock_guard<std::mutex> lockGuard(worker.mutex);
+		if (worker.queue.empty())
+			continue;
+		if (isOwnQueue)
+		{
+			taskId = worker.queue.back();
+			worker.queue.pop_back();
+		}
+		else
+		{
+			taskId = worker.queue.front();
+			worker.queue.pop_front();
+		}
+		--m_queuedTasks;
+		return true;
+	}
+	return false;
+}
+
+void Splashentation::LoadingScheduler::priv_run(const std::size_t workerIndex, const LoadingTaskId taskId)
+{
+	Task& task{ *m_tasks[taskId] };
+	if (m_isCancelled)
+		return;
+
+	try
+	{
+		if (task.function)
+			task.function();
+	}
+	catch (...)
+	{
+		++m_failedTasks;
+	}
+
+	// dependents of this task become ready on this worker
+	for (auto& dependent : task.dependents)
+	{
+		if (--m_tasks[dependent]->remainingDependencies == 0u)
+			priv_push(workerIndex, dependent);
+	}
+
+	m_completedWeight += task.weight;
+	if (++m_completedTasks == m_totalTasks)
+	{
+		// the final task to complete leaves the completion time
+		m_completeTime = getSteadyTimeInMicroseconds();
+		{
+			std::lock_guard<std::mutex> lockGuard(m_sleepMutex);
+			m_isFinished = true;
+		}
+		m_sleepCondition.notify_all();
+	}
+}
+
+bool Splashentation::LoadingScheduler::priv_isFinished() const
+{
+	return m_isFinished;
+}
+
+bool Splashentation::LoadingScheduler::priv_popBackgroundTask(std::function<void()>& function)
+{
+	if (m_backgroundTasks.empty())
+		return false;
+	function = std::move(m_backgroundTasks.front());
+	m_backgroundTasks.pop_front();
+	return true;
+}
+
+void Splashentation::LoadingScheduler::priv_runBackgroundTask(const std::function<void()>& function)
+{
+	try
+	{
+		function();
+	}
+	catch (...)
+	{
+	}
+}
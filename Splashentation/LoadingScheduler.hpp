@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef SPLASHENTATION_LOADINGSCHEDULER_HPP
+#define SPLASHENTATION_LOADINGSCHEDULER_HPP
+
+#include "Standard.hpp"
+
+#include <deque>
+#include <functional>
+
+// work-stealing thread pool that runs weighted loading tasks (with dependencies) and tracks their progress.
+// background tasks (not part of the progress) run one at a time on a background thread, and also on workers that are idle while loading
+class Splashentation::LoadingScheduler
+{
+public:
+	LoadingScheduler();
+	~LoadingScheduler();
+
+	LoadingTaskId addTask(const std::function<void()>& function, float weight, const std::vector<LoadingTaskId>& dependencies);
+	void clearTasks();
+	void start();
+	void cancel();
+	void wait();
+	bool isStarted() const;
+	bool isCancelled() const;
+	bool isComplete() const;
+	LoadingProgress getProgress() const;
+	void addBackgroundTask(const std::function<void()>& function); // can be added at any time. not affected by cancel()
+	void setBackgroundThreadSetup(const std::function<void()>& function); // run at the start of each background thread (not on workers that help with background tasks)
+
+private:
+	struct Task
+	{
+		std::function<void()> function;
+		sf::Uint64 weight; // fixed-point (see weightScale)
+		unsigned int numberOfDependencies;
+		std::atomic<unsigned int> remainingDependencies;
+		std::vector<LoadingTaskId> dependents;
+	};
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<LoadingTaskId> queue;
+	};
+
+	std::vector<std::unique_ptr<Task>> m_tasks;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threads;
+	std::atomic<std::size_t> m_totalTasks; // totals are read with the progress (from other threads) so are not taken from m_tasks
+	std::atomic<sf::Uint64> m_totalWeight;
+	std::atomic<std::size_t> m_queuedTasks;
+	std::atomic<std::size_t> m_completedTasks;
+	std::atomic<std::size_t> m_failedTasks;
+	std::atomic<sf::Uint64> m_completedWeight;
+	std::atomic<bool> m_isStarted;
+	std::atomic<bool> m_isCancelled;
+	std::atomic<bool> m_isFinished; // set by the final task to complete (after m_completeTime)
+	std::atomic<sf::Int64> m_startTime; // microseconds (steady clock)
+	std::atomic<sf::Int64> m_completeTime; // microseconds (steady clock)
+
+	std::mutex m_sleepMutex;
+	std::condition_variable m_sleepCondition;
+
+	std::deque<std::function<void()>> m_backgroundTasks; // guarded by m_sleepMutex
+	std::thread m_backgroundThread;
+	bool m_isBackgroundThreadRunning; // guarded by m_sleepMutex
+	std::function<void()> m_backgroundThreadSetup; // guarded by m_sleepMutex
+
+	void t_work(std::size_t workerIndex);
+	void t_runBackgroundTasks();
+
+	void priv_push(std::size_t workerIndex, LoadingTaskId taskId);
+	bool priv_pop(std::size_t workerIndex, LoadingTaskId& taskId);
+	void priv_run(std::size_t workerIndex, LoadingTaskId taskId);
+	bool priv_isFinished() const;
+	bool priv_popBackgroundTask(std::function<void()>& function); // requires m_sleepMutex
+	static void priv_runBackgroundTask(const std::function<void()>& function);
+};
+
+#endif // SPLASHENTATION_LOADINGSCHEDULER_HPP
@@ -0,0 +1,230 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "ProgressiveTextureLoader.hpp"
+#include "LoadingScheduler.hpp"
+
+#include <SFML/System/Sleep.hpp>
+
+#include <algorithm> // for std::min and std::max
+#include <limits>
+
+Splashentation::ProgressiveTextureLoader::ProgressiveTextureLoader(std::mutex& textureMutex, LoadingScheduler& loadingScheduler)
+	: m_textureMutex(textureMutex)
+	, m_loadingScheduler(loadingScheduler)
+	, m_loads()
+{
+}
+
+Splashentation::ProgressiveTextureLoader::~ProgressiveTextureLoader()
+{
+	cancelAll();
+}
+
+void Splashentation::ProgressiveTextureLoader::add(sf::Texture& texture, const std::function<bool(sf::Image&)>& decode)
+{
+	std::shared_ptr<Load> load(new Load);
+	load->texture = &texture;
+	load->size = texture.getSize();
+	load->isCancelled = false;
+	load->isDecoded = false;
+	load->isDecodeSuccessful = false;
+	load->uploadedRows = 0u;
+
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		for (auto& existingLoad : m_loads)
+		{
+			if (existingLoad->texture == &texture)
+				priv_cancel(*existingLoad);
+		}
+		priv_removeDiscardedLoads();
+		m_loads.push_back(load);
+	}
+
+	// the task keeps the load alive so that a cancelled load can be forgotten without waiting for its decode
+	m_loadingScheduler.addBackgroundTask([load, decode]()
+	{
+		if (!load->isCancelled)
+		{
+			load->isDecodeSuccessful = decode(load->image);
+			if (load->isCancelled)
+				load->image = sf::Image();
+		}
+		load->isDecoded = true;
+	});
+}
+
+void Splashentation::ProgressiveTextureLoader::cancel(const sf::Texture& texture)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	for (auto& load : m_loads)
+	{
+		if (load->texture == &texture)
+			priv_cancel(*load);
+	}
+	priv_removeDiscardedLoads();
+}
+
+void Splashentation::ProgressiveTextureLoader::cancelAll()
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	for (auto& load : m_loads)
+		priv_cancel(*load);
+	priv_removeDiscardedLoads();
+}
+
+bool Splashentation::ProgressiveTextureLoader::update(const std::size_t maximumUploadBytes, const bool canSwap)
+{
+	std::vector<std::shared_ptr<Load>> finishedLoads;
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		priv_update(maximumUploadBytes, canSwap, finishedLoads);
+	}
+	return priv_swap(finishedLoads);
+}
+
+void Splashentation::ProgressiveTextureLoader::finish()
+{
+	std::vector<std::shared_ptr<Load>> finishedLoads;
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		priv_waitForDecodes();
+		priv_update(std::numeric_limits<std::size_t>::max(), true, finishedLoads);
+	}
+	priv_swap(finishedLoads);
+}
+
+Splashentation::MemoryUsage Splashentation::ProgressiveTextureLoader::getMemoryUsage() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	MemoryUsage usage;
+	for (auto& load : m_loads)
+		usage += estimateMemoryUsage(load->size);
+	return usage;
+}
+
+// the decoded image and the texture it is uploaded to (both exist while uploading)
+Splashentation::MemoryUsage Splashentation::ProgressiveTextureLoader::estimateMemoryUsage(const sf::Vector2u size)
+{
+	const std::size_t bytes{ static_cast<std::size_t>(size.x) * size.y * 4u };
+	return{ sizeof(Load) + bytes, bytes };
+}
+
+
+
+// PRIVATE
+
+void Splashentation::ProgressiveTextureLoader::priv_cancel(Load& load)
+{
+	load.texture = nullptr;
+	load.isCancelled = true;
+}
+
+// cancelled loads are kept (and counted) until their decodes have finished
+void Splashentation::ProgressiveTextureLoader::priv_removeDiscardedLoads()
+{
+	m_loads.erase(std::remove_if(m_loads.begin(), m_loads.end(), [](const std::shared_ptr<Load>& load) { return (load->isCancelled) && (load->isDecoded); }), m_loads.end());
+}
+
+void Splashentation::ProgressiveTextureLoader::priv_waitForDecodes()
+{
+	for (auto& load : m_loads)
+	{
+		while (!load->isDecoded)
+			sf::sleep(sf::milliseconds(1));
+	}
+}
+
+// loads ready to swap stay listed (so that cancelling them is still seen) until they are swapped
+void Splashentation::ProgressiveTextureLoader::priv_update(const std::size_t maximumUploadBytes, const bool canSwap, std::vector<std::shared_ptr<Load>>& finishedLoads)
+{
+	std::size_t remainingUploadBytes{ maximumUploadBytes };
+	for (std::vector<std::shared_ptr<Load>>::iterator load{ m_loads.begin() }; load != m_loads.end();)
+	{
+		Load& currentLoad{ **load };
+		if ((currentLoad.isDecoded) && ((currentLoad.isCancelled) || (!currentLoad.isDecodeSuccessful)))
+		{
+			load = m_loads.erase(load); // a failed decode keeps the placeholder
+			continue;
+		}
+		if ((currentLoad.isDecoded) && (priv_upload(currentLoad, remainingUploadBytes)) && (canSwap))
+			finishedLoads.push_back(*load);
+		++load;
+	}
+}
+
+// swapping keeps the texture object (that sprites point to) and exchanges its contents. a failed upload keeps the placeholder
+bool Splashentation::ProgressiveTextureLoader::priv_swap(std::vector<std::shared_ptr<Load>>& finishedLoads)
+{
+	bool isSwapped{ false };
+	for (auto& load : finishedLoads)
+	{
+		std::lock_guard<std::mutex> textureLockGuard(m_textureMutex);
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		if ((!load->isCancelled) && (load->isDecodeSuccessful))
+		{
+			load->fullTexture.setSmooth(load->texture->isSmooth());
+			load->fullTexture.setRepeated(load->texture->isRepeated());
+			load->texture->swap(load->fullTexture);
+			isSwapped = true;
+		}
+		m_loads.erase(std::remove(m_loads.begin(), m_loads.end(), load), m_loads.end());
+	}
+	finishedLoads.clear();
+	return isSwapped;
+}
+
+bool Splashentation::ProgressiveTextureLoader::priv_upload(Load& load, std::size_t& remainingUploadBytes)
+{
+	const sf::Vector2u size{ load.image.getSize() };
+	if (load.uploadedRows >= size.y)
+		return true;
+	if (remainingUploadBytes == 0u)
+		return false;
+	if ((load.uploadedRows == 0u) && (!load.fullTexture.create(size.x, size.y)))
+	{
+		load.isDecodeSuccessful = false;
+		return true;
+	}
+
+	const std::size_t rowBytes{ static_cast<std::size_t>(size.x) * 4u };
+	const unsigned int rows{ static_cast<unsigned int>(std::min(std::max(remainingUploadBytes / rowBytes, static_cast<std::size_t>(1u)), static_cast<std::size_t>(size.y - load.uploadedRows))) };
+	load.fullTexture.update(load.image.getPixelsPtr() + load.uploadedRows * rowBytes, size.x, rows, 0u, load.uploadedRows);
+	load.uploadedRows += rows;
+	remainingUploadBytes -= std::min(remainingUploadBytes, rows * rowBytes);
+	if (load.uploadedRows < size.y)
+		return false;
+
+	load.image = sf::Image(); // release the decoded pixels once uploaded
+	return true;
+}
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#ifndef SPLASHENTATION_PROGRESSIVETEXTURELOADER_HPP
+#define SPLASHENTATION_PROGRESSIVETEXTURELOADER_HPP
+
+#include "Standard.hpp"
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+
+// decodes full resolution images (as background tasks of the loading scheduler) for textures that show a low resolution placeholder until then.
+// decoded images are uploaded in bands of rows (limited per call) to a separate texture that is swapped in once complete
+class Splashentation::ProgressiveTextureLoader
+{
+public:
+	ProgressiveTextureLoader(std::mutex& textureMutex, LoadingScheduler& loadingScheduler); // texture mutex is held while a texture is swapped
+	~ProgressiveTextureLoader();
+
+	void add(sf::Texture& texture, const std::function<bool(sf::Image&)>& decode); // texture must already be the size of the decoded image
+	void cancel(const sf::Texture& texture); // does not wait. a decode that has started finishes in the background and is discarded. the placeholder is kept
+	void cancelAll();
+	bool update(std::size_t maximumUploadBytes, bool canSwap); // requires an active context. returns true if a texture was swapped
+	void finish(); // requires an active context. waits for all decodes then uploads and swaps them
+	MemoryUsage getMemoryUsage() const; // decoded images and their textures (counted at their full size from when they are added until they are swapped in or discarded)
+	static MemoryUsage estimateMemoryUsage(sf::Vector2u size); // of one load
+
+private:
+	struct Load
+	{
+		sf::Texture* texture; // null once cancelled
+		sf::Vector2u size;
+		sf::Image image;
+		std::atomic<bool> isCancelled;
+		std::atomic<bool> isDecoded; // also set when a cancelled load is skipped
+		bool isDecodeSuccessful; // only valid once decoded
+		sf::Texture fullTexture;
+		unsigned int uploadedRows;
+	};
+
+	std::mutex& m_textureMutex;
+	LoadingScheduler& m_loadingScheduler;
+	std::vector<std::shared_ptr<Load>> m_loads; // shared with their decode tasks
+	mutable std::mutex m_mutex;
+
+	void priv_cancel(Load& load); // requires m_mutex
+	void priv_removeDiscardedLoads(); // requires m_mutex
+	void priv_waitForDecodes(); // requires m_mutex
+	void priv_update(std::size_t maximumUploadBytes, bool canSwap, std::vector<std::shared_ptr<Load>>& finishedLoads); // requires m_mutex
+	bool priv_upload(Load& load, std::size_t& remainingUploadBytes); // returns true once the whole image has been uploaded
+	bool priv_swap(std::vector<std::shared_ptr<Load>>& finishedLoads); // takes the texture mutex before m_mutex (the order used by other threads)
+};
+
+#endif // SPLASHENTATION_PROGRESSIVETEXTURELOADER_HPP
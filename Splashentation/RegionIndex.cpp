@@ -0,0 +1,189 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "RegionIndex.hpp"
+
+#include <algorithm> // for std::find
+#include <cmath> // for std::floor
+
+namespace
+{
+
+const int maximumCellsPerRegion{ 256 }; // larger regions are tested for every point instead of being added to their cells
+
+sf::Uint64 getCellKey(const int x, const int y)
+{
+	return (static_cast<sf::Uint64>(static_cast<sf::Uint32>(x)) << 32u) | static_cast<sf::Uint32>(y);
+}
+
+int getCell(const float coordinate, const float cellSize)
+{
+	return static_cast<int>(std::floor(coordinate / cellSize));
+}
+
+void removeKey(std::vector<std::size_t>& keys, const std::size_t key)
+{
+	const std::vector<std::size_t>::iterator found{ std::find(keys.begin(), keys.end(), key) };
+	if (found == keys.end())
+		return;
+	*found = keys.back();
+	keys.pop_back();
+}
+
+} // namespace
+
+Splashentation::RegionIndex::RegionIndex(const float cellSize)
+	: m_cellSize(cellSize)
+	, m_size(0u)
+	, m_regions()
+	, m_cells()
+	, m_oversizedRegions()
+{
+	assert(cellSize > 0.f);
+}
+
+void Splashentation::RegionIndex::clear()
+{
+	m_size = 0u;
+	m_regions.clear();
+	m_cells.clear();
+	m_oversizedRegions.clear();
+}
+
+void Splashentation::RegionIndex::set(const std::size_t key, const sf::FloatRect& localBounds, const sf::Transform& transform, const int zIndex)
+{
+	if (key >= m_regions.size())
+		m_regions.resize(key + 1u, Region{ false, false, sf::FloatRect(), sf::Transform(), 0, sf::IntRect() });
+	priv_unlink(key);
+
+	// a region without area (such as a drawable scaled to zero) cannot be hit. its transform has no inverse (SFML would give identity)
+	const float* const matrix{ transform.getMatrix() };
+	if ((localBounds.width * localBounds.height * (matrix[0] * matrix[5] - matrix[1] * matrix[4])) == 0.f)
+		return;
+
+	const sf::FloatRect bounds{ transform.transformRect(localBounds) };
+	Region& region{ m_regions[key] };
+	region.isUsed = true;
+	region.localBounds = localBounds;
+	region.inverseTransform = transform.getInverse();
+	region.zIndex = zIndex;
+	region.cells.left = getCell(bounds.left, m_cellSize);
+	region.cells.top = getCell(bounds.top, m_cellSize);
+	region.cells.width = getCell(bounds.left + bounds.width, m_cellSize) - region.cells.left + 1;
+	region.cells.height = getCell(bounds.top + bounds.height, m_cellSize) - region.cells.top + 1;
+	region.isOversized = (static_cast<sf::Int64>(region.cells.width) * region.cells.height > maximumCellsPerRegion);
+	++m_size;
+
+	if (region.isOversized)
+	{
+		m_oversizedRegions.push_back(key);
+		return;
+	}
+	for (int y{ region.cells.top }; y < region.cells.top + region.cells.height; ++y)
+	{
+		for (int x{ region.cells.left }; x < region.cells.left + region.cells.width; ++x)
+			m_cells[getCellKey(x, y)].push_back(key);
+	}
+}
+
+void Splashentation::RegionIndex::remove(const std::size_t key)
+{
+	if (key < m_regions.size())
+		priv_unlink(key);
+}
+
+bool Splashentation::RegionIndex::find(const sf::Vector2f point, std::size_t& key) const
+{
+	bool isFound{ false };
+	auto test = [&](const std::size_t candidate)
+	{
+		const Region& region{ m_regions[candidate] };
+		if ((isFound) && (!priv_isAbove(region, candidate, key)))
+			return;
+		if (!region.localBounds.contains(region.inverseTransform.transformPoint(point)))
+			return;
+		key = candidate;
+		isFound = true;
+	};
+
+	const std::unordered_map<sf::Uint64, std::vector<std::size_t>>::const_iterator cell{ m_cells.find(getCellKey(getCell(point.x, m_cellSize), getCell(point.y, m_cellSize))) };
+	if (cell != m_cells.end())
+	{
+		for (auto& candidate : cell->second)
+			test(candidate);
+	}
+	for (auto& candidate : m_oversizedRegions)
+		test(candidate);
+	return isFound;
+}
+
+std::size_t Splashentation::RegionIndex::getSize() const
+{
+	return m_size;
+}
+
+
+
+// PRIVATE
+
+void Splashentation::RegionIndex::priv_unlink(const std::size_t key)
+{
+	Region& region{ m_regions[key] };
+	if (!region.isUsed)
+		return;
+
+	region.isUsed = false;
+	--m_size;
+	if (region.isOversized)
+	{
+		removeKey(m_oversizedRegions, key);
+		return;
+	}
+	for (int y{ region.cells.top }; y < region.cells.top + region.cells.height; ++y)
+	{
+		for (int x{ region.cells.left }; x < region.cells.left + region.cells.width; ++x)
+		{
+			const std::unordered_map<sf::Uint64, std::vector<std::size_t>>::iterator cell{ m_cells.find(getCellKey(x, y)) };
+			if (cell == m_cells.end())
+				continue;
+			removeKey(cell->second, key);
+			if (cell->second.empty())
+				m_cells.erase(cell);
+		}
+	}
+}
+
+bool Splashentation::RegionIndex::priv_isAbove(const Region& region, const std::size_t key, const std::size_t otherKey) const
+{
+	const int otherZIndex{ m_regions[otherKey].zIndex };
+	return (region.zIndex > otherZIndex) || ((region.zIndex == otherZIndex) && (key > otherKey));
+}
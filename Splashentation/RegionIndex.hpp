@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#ifndef SPLASHENTATION_REGIONINDEX_HPP
+#define SPLASHENTATION_REGIONINDEX_HPP
+
+#include "Standard.hpp"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+
+// spatial index of (transformed) rectangular regions for hit testing. regions are kept in a sparse uniform grid
+// so that finding the region under a point only tests the regions sharing its cell. regions can be moved individually.
+// regions covering very many cells are kept aside and always tested
+class Splashentation::RegionIndex
+{
+public:
+	explicit RegionIndex(float cellSize = 64.f);
+
+	void clear();
+	void set(std::size_t key, const sf::FloatRect& localBounds, const sf::Transform& transform, int zIndex); // adds the region or moves it (a region without area is removed)
+	void remove(std::size_t key);
+	bool find(sf::Vector2f point, std::size_t& key) const; // topmost region containing the point (highest z index, then highest key)
+	std::size_t getSize() const;
+
+private:
+	struct Region
+	{
+		bool isUsed;
+		bool isOversized;
+		sf::FloatRect localBounds;
+		sf::Transform inverseTransform;
+		int zIndex;
+		sf::IntRect cells;
+	};
+	float m_cellSize;
+	std::size_t m_size;
+	std::vector<Region> m_regions; // indexed by key
+	std::unordered_map<sf::Uint64, std::vector<std::size_t>> m_cells; // keys of the regions overlapping each cell (only cells in use)
+	std::vector<std::size_t> m_oversizedRegions;
+
+	void priv_unlink(std::size_t key);
+	bool priv_isAbove(const Region& region, std::size_t key, std::size_t otherKey) const;
+};
+
+#endif // SPLASHENTATION_REGIONINDEX_HPP
@@ -0,0 +1,360 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "RemoteChannel.hpp"
+#include "SteadyTime.hpp"
+
+#include <SFML/System/Sleep.hpp>
+
+#include <cstring> // for std::memcpy and std::memcmp
+#include <new> // for placement new
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // defined(__unix__) || defined(__APPLE__)
+
+namespace
+{
+
+const char remoteChannelMagic[4]{ 'S', 'P', 'R', 'C' };
+const sf::Uint32 remoteChannelVersion{ 2u };
+const sf::Uint32 wrapMarker{ 0xFFFFFFFFu }; // the rest of the ring (up to its end) is unused
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The remote channel requires lock-free 64-bit atomics (they are shared between processes)");
+
+// positions count bytes since the channel was created; each is advanced by only one process
+struct SharedHeader
+{
+	char magic[4];
+	sf::Uint32 version;
+	sf::Uint64 capacity;
+	alignas(64) std::atomic<sf::Uint64> writePosition; // application
+	alignas(64) std::atomic<sf::Uint64> readPosition; // host
+	std::atomic<sf::Uint32> resyncRequests; // host. increased when a damaged stream is dropped so that the application restarts its stream (with a trace header)
+	alignas(64) std::atomic<sf::Uint32> hostPlayState;
+	std::atomic<sf::Uint32> hostSlideIndex;
+	std::atomic<sf::Int64> hostSlideTime; // microseconds
+	std::atomic<sf::Uint32> hostFrame;
+};
+
+SharedHeader& getHeader(void* mapping)
+{
+	return *static_cast<SharedHeader*>(mapping);
+}
+
+sf::Uint8* getRing(void* mapping)
+{
+	return static_cast<sf::Uint8*>(mapping) + sizeof(SharedHeader);
+}
+
+sf::Uint64 alignMessageSize(const sf::Uint64 size)
+{
+	return (size + 3u) & ~sf::Uint64(3u);
+}
+
+std::string getSharedMemoryName(const std::string& name)
+{
+	return (name.empty() || (name[0] != '/')) ? "/" + name : name;
+}
+
+using SplashentationInternal::getSteadyTimeInMicroseconds;
+
+} // namespace
+
+Splashentation::RemoteChannel::RemoteChannel()
+	: m_name()
+	, m_isHost(false)
+	, m_mapping(nullptr)
+	, m_mappingSize(0u)
+	, m_writer()
+	, m_reader()
+	, m_outgoing()
+	, m_incoming()
+	, m_message()
+	, m_isStreamStarted(false)
+	, m_answeredResyncRequests(0u)
+{
+}
+
+Splashentation::RemoteChannel::~RemoteChannel()
+{
+	close();
+}
+
+bool Splashentation::RemoteChannel::create(const std::string& name, const std::size_t capacity)
+{
+	close();
+#ifdef SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+	const std::string sharedMemoryName{ getSharedMemoryName(name) };
+	shm_unlink(sharedMemoryName.c_str()); // left behind by a host that did not close
+	const int fileDescriptor{ shm_open(sharedMemoryName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) };
+	if (fileDescriptor < 0)
+		return false;
+	const sf::Uint64 ringCapacity{ alignMessageSize(std::max(capacity, std::size_t(4096u))) };
+	const std::size_t mappingSize{ sizeof(SharedHeader) + static_cast<std::size_t>(ringCapacity) };
+	void* mapping{ (ftruncate(fileDescriptor, static_cast<off_t>(mappingSize)) == 0) ? mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0) : MAP_FAILED };
+	::close(fileDescriptor);
+	if (mapping == MAP_FAILED)
+	{
+		shm_unlink(sharedMemoryName.c_str());
+		return false;
+	}
+
+	SharedHeader* header{ new (mapping) SharedHeader };
+	header->version = remoteChannelVersion;
+	header->capacity = ringCapacity;
+	header->writePosition = 0u;
+	header->readPosition = 0u;
+	header->resyncRequests = 0u;
+	header->hostPlayState = static_cast<sf::Uint32>(PlayState::Ready);
+	header->hostSlideIndex = 0u;
+	header->hostSlideTime = 0;
+	header->hostFrame = 0u;
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(header->magic, remoteChannelMagic, 4u); // last so that an application never opens a partially created channel
+
+	m_name = sharedMemoryName;
+	m_isHost = true;
+	m_mapping = mapping;
+	m_mappingSize = mappingSize;
+	m_isStreamStarted = false;
+	return true;
+#else // SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+	return false;
+#endif // SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+}
+
+bool Splashentation::RemoteChannel::open(const std::string& name)
+{
+	close();
+#ifdef SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+	const std::string sharedMemoryName{ getSharedMemoryName(name) };
+	const int fileDescriptor{ shm_open(sharedMemoryName.c_str(), O_RDWR, 0) };
+	if (fileDescriptor < 0)
+		return false;
+	struct stat fileStatus;
+	if ((fstat(fileDescriptor, &fileStatus) != 0) || (static_cast<std::size_t>(fileStatus.st_size) <= sizeof(SharedHeader)))
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+	const std::size_t mappingSize{ static_cast<std::size_t>(fileStatus.st_size) };
+	void* mapping{ mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0) };
+	::close(fileDescriptor);
+	if (mapping == MAP_FAILED)
+		return false;
+
+	const SharedHeader& header{ getHeader(mapping) };
+	if ((std::memcmp(header.magic, remoteChannelMagic, 4u) != 0) || (header.version != remoteChannelVersion) || (sizeof(SharedHeader) + header.capacity != mappingSize))
+	{
+		munmap(mapping, mappingSize);
+		return false;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	m_name = sharedMemoryName;
+	m_isHost = false;
+	m_mapping = mapping;
+	m_mappingSize = mappingSize;
+	m_answeredResyncRequests = header.resyncRequests.load(std::memory_order_acquire);
+
+	// the trace header is the first message
+	m_outgoing.str("");
+	m_writer.open(m_outgoing);
+	if (priv_push(m_outgoing.str(), sf::seconds(1.f)))
+		return true;
+	close();
+	return false;
+#else // SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+	return false;
+#endif // SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+}
+
+void Splashentation::RemoteChannel::close()
+{
+#ifdef SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+	if (m_mapping == nullptr)
+		return;
+	munmap(m_mapping, m_mappingSize);
+	if (m_isHost)
+		shm_unlink(m_name.c_str());
+#endif // SPLASHENTATION_REMOTE_CHANNEL_SHARED_MEMORY
+	m_mapping = nullptr;
+	m_mappingSize = 0u;
+	m_name.clear();
+}
+
+bool Splashentation::RemoteChannel::send(const TraceRecord& record, const sf::Time timeout)
+{
+	if ((m_mapping == nullptr) || (m_isHost))
+		return false;
+
+	// the host dropped a damaged stream so the stream is restarted (ids are interned again)
+	const sf::Uint32 resyncRequests{ getHeader(m_mapping).resyncRequests.load(std::memory_order_acquire) };
+	if (resyncRequests != m_answeredResyncRequests)
+	{
+		m_outgoing.str("");
+		m_writer.open(m_outgoing);
+		if (!priv_push(m_outgoing.str(), timeout))
+			return false;
+		m_answeredResyncRequests = resyncRequests;
+	}
+
+	m_outgoing.str("");
+	m_writer.write(record);
+	return priv_push(m_outgoing.str(), timeout);
+}
+
+bool Splashentation::RemoteChannel::receive(TraceRecord& record)
+{
+	if ((m_mapping == nullptr) || (!m_isHost))
+		return false;
+
+	// a new application starts its stream with a trace header
+	while (priv_pop(m_message))
+	{
+		m_incoming.str(m_message);
+		m_incoming.clear();
+		if (!m_isStreamStarted)
+		{
+			m_isStreamStarted = m_reader.open(m_incoming);
+			continue;
+		}
+		if (m_reader.read(record))
+			return true;
+		// a header here means that another application connected
+		m_incoming.str(m_message);
+		m_incoming.clear();
+		m_reader.open(m_incoming);
+	}
+	return false;
+}
+
+void Splashentation::RemoteChannel::setHostState(const PlayState playState, const unsigned int slideIndex, const sf::Time slideTime)
+{
+	if (m_mapping == nullptr)
+		return;
+
+	SharedHeader& header{ getHeader(m_mapping) };
+	header.hostPlayState.store(static_cast<sf::Uint32>(playState), std::memory_order_relaxed);
+	header.hostSlideIndex.store(slideIndex, std::memory_order_relaxed);
+	header.hostSlideTime.store(slideTime.asMicroseconds(), std::memory_order_relaxed);
+	header.hostFrame.fetch_add(1u, std::memory_order_release);
+}
+
+Splashentation::RemoteChannel::HostState Splashentation::RemoteChannel::getHostState() const
+{
+	HostState state{ PlayState::Quit, 0u, sf::Time::Zero, 0u };
+	if (m_mapping == nullptr)
+		return state;
+
+	const SharedHeader& header{ getHeader(m_mapping) };
+	state.frame = header.hostFrame.load(std::memory_order_acquire);
+	state.playState = static_cast<PlayState>(header.hostPlayState.load(std::memory_order_relaxed));
+	state.slideIndex = header.hostSlideIndex.load(std::memory_order_relaxed);
+	state.slideTime = sf::microseconds(header.hostSlideTime.load(std::memory_order_relaxed));
+	return state;
+}
+
+
+
+// PRIVATE
+
+// [length (4 bytes)] [message] padded to 4 bytes. a message that does not fit before the end of the ring starts again at the beginning
+bool Splashentation::RemoteChannel::priv_push(const std::string& message, const sf::Time timeout)
+{
+	SharedHeader& header{ getHeader(m_mapping) };
+	const sf::Uint64 capacity{ header.capacity };
+	const sf::Uint64 recordSize{ 4u + alignMessageSize(message.size()) };
+	if (recordSize > capacity / 2u)
+		return false;
+
+	const sf::Uint64 writePosition{ header.writePosition.load(std::memory_order_relaxed) };
+	const sf::Uint64 offset{ writePosition % capacity };
+	const sf::Uint64 contiguous{ capacity - offset };
+	const sf::Uint64 requiredSize{ (contiguous < recordSize) ? contiguous + recordSize : recordSize };
+	const sf::Int64 startTime{ getSteadyTimeInMicroseconds() };
+	while (capacity - (writePosition - header.readPosition.load(std::memory_order_acquire)) < requiredSize)
+	{
+		if (getSteadyTimeInMicroseconds() - startTime > timeout.asMicroseconds())
+			return false;
+		sf::sleep(sf::microseconds(500));
+	}
+
+	sf::Uint8* ring{ getRing(m_mapping) };
+	sf::Uint64 position{ writePosition };
+	if (contiguous < recordSize)
+	{
+		std::memcpy(ring + offset, &wrapMarker, 4u);
+		position += contiguous;
+	}
+	const sf::Uint32 length{ static_cast<sf::Uint32>(message.size()) };
+	std::memcpy(ring + position % capacity, &length, 4u);
+	std::memcpy(ring + position % capacity + 4u, message.data(), message.size());
+	header.writePosition.store(position + recordSize, std::memory_order_release);
+	return true;
+}
+
+bool Splashentation::RemoteChannel::priv_pop(std::string& message)
+{
+	SharedHeader& header{ getHeader(m_mapping) };
+	const sf::Uint64 capacity{ header.capacity };
+	const sf::Uint64 writePosition{ header.writePosition.load(std::memory_order_acquire) };
+	sf::Uint64 position{ header.readPosition.load(std::memory_order_relaxed) };
+	if (position == writePosition)
+		return false;
+
+	const sf::Uint8* ring{ getRing(m_mapping) };
+	sf::Uint32 length;
+	std::memcpy(&length, ring + position % capacity, 4u);
+	if (length == wrapMarker)
+	{
+		position += capacity - position % capacity;
+		std::memcpy(&length, ring, 4u);
+	}
+	const sf::Uint64 recordSize{ 4u + alignMessageSize(length) };
+	if ((recordSize > capacity / 2u) || (recordSize > writePosition - position))
+	{
+		// damaged (or written by something else): drop everything written so far
+		header.readPosition.store(writePosition, std::memory_order_release);
+		header.resyncRequests.fetch_add(1u, std::memory_order_release);
+		m_isStreamStarted = false;
+		return false;
+	}
+	message.assign(reinterpret_cast<const char*>(ring + position % capacity + 4u), length);
+	header.readPosition.store(position + recordSize, std::memory_order_release);
+	return true;
+}
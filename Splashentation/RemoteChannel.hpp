@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#ifndef SPLASHENTATION_REMOTECHANNEL_HPP
+#define SPLASHENTATION_REMOTECHANNEL_HPP
+
+#include "Standard.hpp"
+#include "Trace.hpp"
+
+#include <sstream>
+
+// named shared memory between an application (which sends) and a host process (which receives and renders the presentation).
+// records are sent through a single-producer, single-consumer lock-free ring using the trace format (one record per message).
+// the host publishes its state in the same memory so that the application can follow the presentation
+class Splashentation::RemoteChannel
+{
+public:
+	struct HostState
+	{
+		PlayState playState;
+		unsigned int slideIndex;
+		sf::Time slideTime;
+		sf::Uint32 frame; // advances every frame while the host is playing
+	};
+
+	RemoteChannel();
+	~RemoteChannel();
+
+	bool create(const std::string& name, std::size_t capacity); // host. replaces any channel left behind with the same name
+	bool open(const std::string& name); // application. fails if the host has not created the channel (yet)
+	void close(); // the host also removes the name
+	bool send(const TraceRecord& record, sf::Time timeout); // application. fails if the ring stays full for the timeout (the host is not receiving)
+	bool receive(TraceRecord& record); // host. false if there is nothing (valid) to receive. a damaged stream is dropped and the application asked to restart it
+	void setHostState(PlayState playState, unsigned int slideIndex, sf::Time slideTime);
+	HostState getHostState() const;
+
+private:
+	std::string m_name;
+	bool m_isHost;
+	void* m_mapping;
+	std::size_t m_mappingSize;
+	TraceWriter m_writer;
+	TraceReader m_reader;
+	std::ostringstream m_outgoing;
+	std::istringstream m_incoming;
+	std::string m_message;
+	bool m_isStreamStarted; // the host has received the trace header
+	sf::Uint32 m_answeredResyncRequests; // the application has restarted its stream for these (see SharedHeader::resyncRequests)
+
+	bool priv_push(const std::string& message, sf::Time timeout);
+	bool priv_pop(std::string& message);
+};
+
+#endif // SPLASHENTATION_REMOTECHANNEL_HPP
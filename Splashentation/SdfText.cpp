@@ -0,0 +1,688 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "SdfText.hpp"
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <algorithm> // for std::sort
+#include <fstream>
+#include <cstdio> // for std::rename and std::remove
+#include <cstring> // for std::memcmp and std::memcpy
+#include <cmath> // for std::sqrt
+
+namespace
+{
+
+const unsigned int baseSize{ 48u };
+const unsigned int spread{ 6u };
+const unsigned int atlasPadding{ 1u };
+const double infinity{ 1e20 };
+
+// the field is stored in alpha. edge width is taken from screen-space derivatives so edges stay sharp at any scale
+const std::string fragmentShader{
+	"uniform sampler2D texture;\n"
+	"void main()\n"
+	"{\n"
+	"	float distance = texture2D(texture, gl_TexCoord[0].xy).a;\n"
+	"	float width = clamp(fwidth(distance) * 0.7, 0.001, 0.5);\n"
+	"	gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * smoothstep(0.5 - width, 0.5 + width, distance));\n"
+	"}\n" };
+
+const char cacheMagic[4]{ 'S', 'P', 'S', 'D' };
+const sf::Uint32 cacheVersion{ 1u };
+
+struct CacheHeader
+{
+	char magic[4];
+	sf::Uint32 version;
+	sf::Uint32 baseSize;
+	sf::Uint32 spread;
+	sf::Uint32 numberOfGlyphs;
+	sf::Uint32 numberOfKernings;
+	sf::Uint32 atlasWidth;
+	sf::Uint32 atlasHeight;
+	float lineSpacing;
+	sf::Uint8 padding[28];
+};
+static_assert(sizeof(CacheHeader) == 64u, "SDF font cache header must be 64 bytes");
+
+struct CacheGlyph
+{
+	sf::Uint32 codePoint;
+	float advance;
+	float bounds[4];
+	sf::Int32 textureRect[4];
+};
+
+struct CacheKerning
+{
+	sf::Uint64 pair;
+	float kerning;
+	sf::Uint32 padding;
+};
+
+struct GlyphField
+{
+	sf::Uint32 codePoint;
+	unsigned int width;
+	unsigned int height;
+	std::vector<sf::Uint8> distances;
+};
+
+// printable ascii and latin-1
+std::vector<sf::Uint32> getCodePoints()
+{
+	std::vector<sf::Uint32> codePoints;
+	for (sf::Uint32 codePoint{ 32u }; codePoint < 127u; ++codePoint)
+		codePoints.push_back(codePoint);
+	for (sf::Uint32 codePoint{ 160u }; codePoint < 256u; ++codePoint)
+		codePoints.push_back(codePoint);
+	return codePoints;
+}
+
+sf::Uint64 getKerningPair(const sf::Uint32 first, const sf::Uint32 second)
+{
+	return (static_cast<sf::Uint64>(first) << 32u) | second;
+}
+
+// squared distance from each sample to the nearest zero of f along a line (Felzenszwalb and Huttenlocher)
+void calculateSquaredDistances1d(const std::vector<double>& f, std::vector<double>& d, const std::size_t n, std::vector<std::size_t>& v, std::vector<double>& z)
+{
+	const auto intersection = [&f](const std::size_t q, const std::size_t p)
+	{
+		return ((f[q] + static_cast<double>(q * q)) - (f[p] + static_cast<double>(p * p))) / (2.0 * q - 2.0 * p);
+	};
+
+	std::size_t k{ 0u };
+	v[0u] = 0u;
+	z[0u] = -infinity;
+	z[1u] = infinity;
+	for (std::size_t q{ 1u }; q < n; ++q)
+	{
+		double s{ intersection(q, v[k]) };
+		while (s <= z[k])
+		{
+			--k;
+			s = intersection(q, v[k]);
+		}
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1u] = infinity;
+	}
+	k = 0u;
+	for (std::size_t q{ 0u }; q < n; ++q)
+	{
+		while (z[k + 1u] < q)
+			++k;
+		const double offset{ static_cast<double>(q) - static_cast<double>(v[k]) };
+		d[q] = offset * offset + f[v[k]];
+	}
+}
+
+// squared distance from each pixel to the nearest pixel whose inside state is insideState
+std::vector<double> calculateSquaredDistances(const std::vector<bool>& isInside, const bool insideState, const unsigned int width, const unsigned int height)
+{
+	std::vector<double> grid(isInside.size());
+	for (std::size_t i{ 0u }; i < isInside.size(); ++i)
+		grid[i] = (isInside[i] == insideState) ? 0.0 : infinity;
+
+	const std::size_t length{ std::max(width, height) };
+	std::vector<double> f(length), d(length), z(length + 1u);
+	std::vector<std::size_t> v(length);
+	for (unsigned int x{ 0u }; x < width; ++x)
+	{
+		for (unsigned int y{ 0u }; y < height; ++y)
+			f[y] = grid[y * width + x];
+		calculateSquaredDistances1d(f, d, height, v, z);
+		for (unsigned int y{ 0u }; y < height; ++y)
+			grid[y * width + x] = d[y];
+	}
+	for (unsigned int y{ 0u }; y < height; ++y)
+	{
+		std::copy(grid.begin() + y * width, grid.begin() + (y + 1u) * width, f.begin());
+		calculateSquaredDistances1d(f, d, width, v, z);
+		std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+	}
+	return grid;
+}
+
+// 0.5 is the edge, 0 is spread pixels (or further) outside and 1 is spread pixels (or further) inside
+std::vector<sf::Uint8> calculateSignedDistanceField(const std::vector<bool>& isInside, const unsigned int width, const unsigned int height)
+{
+	const std::vector<double> distancesToInside{ calculateSquaredDistances(isInside, true, width, height) };
+	const std::vector<double> distancesToOutside{ calculateSquaredDistances(isInside, false, width, height) };
+	std::vector<sf::Uint8> field(isInside.size());
+	for (std::size_t i{ 0u }; i < field.size(); ++i)
+	{
+		// pixel centres are half a pixel from the edge between inside and outside pixels
+		const double signedDistance{ isInside[i] ? 0.5 - std::sqrt(distancesToOutside[i]) : std::sqrt(distancesToInside[i]) - 0.5 };
+		const double value{ std::min(std::max(0.5 - signedDistance / (2.0 * spread), 0.0), 1.0) };
+		field[i] = static_cast<sf::Uint8>(value * 255.0 + 0.5);
+	}
+	return field;
+}
+
+// coverage at base size for drawing without a shader
+sf::Uint8 convertDistanceToCoverage(const sf::Uint8 distance)
+{
+	const float coverage{ (distance / 255.f - 0.5f) * 2.f * spread + 0.5f };
+	return static_cast<sf::Uint8>(std::min(std::max(coverage, 0.f), 1.f) * 255.f + 0.5f);
+}
+
+template <class T>
+bool readValue(std::ifstream& file, T& value)
+{
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <class T>
+void writeValue(std::ofstream& file, const T& value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+
+
+Splashentation::SdfFont::SdfFont()
+	: m_glyphs()
+	, m_kernings()
+	, m_lineSpacing(0.f)
+	, m_texture()
+	, m_shader(nullptr)
+{
+}
+
+bool Splashentation::SdfFont::loadFromFile(const std::string& filename, const std::string& cacheFilename, const std::function<bool(std::size_t)>& isAffordable)
+{
+	// loaded into a separate font so that a failed load leaves this one (and any text using it) unchanged
+	SdfFont font;
+	std::vector<sf::Uint8> atlas;
+	sf::Vector2u atlasSize;
+	if ((cacheFilename == "") || (!font.priv_loadCache(cacheFilename, atlas, atlasSize)))
+	{
+		if (!font.priv_build(filename, atlas, atlasSize))
+			return false;
+		if (cacheFilename != "")
+			font.priv_saveCache(cacheFilename, atlas, atlasSize);
+	}
+	if ((isAffordable) && (!isAffordable(font.getMetricsMemory() + static_cast<std::size_t>(atlasSize.x) * atlasSize.y * 4u)))
+		return false;
+	if (!font.priv_createTexture(atlas, atlasSize))
+		return false;
+
+	m_glyphs.swap(font.m_glyphs);
+	m_kernings.swap(font.m_kernings);
+	m_lineSpacing = font.m_lineSpacing;
+	m_texture.swap(font.m_texture);
+	m_shader.swap(font.m_shader);
+	return true;
+}
+
+const Splashentation::SdfFont::Glyph* Splashentation::SdfFont::getGlyph(const sf::Uint32 codePoint) const
+{
+	const std::unordered_map<sf::Uint32, Glyph>::const_iterator glyph{ m_glyphs.find(codePoint) };
+	return (glyph != m_glyphs.end()) ? &glyph->second : nullptr;
+}
+
+float Splashentation::SdfFont::getKerning(const sf::Uint32 first, const sf::Uint32 second) const
+{
+	const std::unordered_map<sf::Uint64, float>::const_iterator kerning{ m_kernings.find(getKerningPair(first, second)) };
+	return (kerning != m_kernings.end()) ? kerning->second : 0.f;
+}
+
+float Splashentation::SdfFont::getLineSpacing() const
+{
+	return m_lineSpacing;
+}
+
+float Splashentation::SdfFont::getBaseSize() const
+{
+	return static_cast<float>(baseSize);
+}
+
+float Splashentation::SdfFont::getSpread() const
+{
+	return static_cast<float>(spread);
+}
+
+const sf::Texture& Splashentation::SdfFont::getTexture() const
+{
+	return m_texture;
+}
+
+const sf::Shader* Splashentation::SdfFont::getShader() const
+{
+	return m_shader.get();
+}
+
+std::size_t Splashentation::SdfFont::getMetricsMemory() const
+{
+	return sizeof(SdfFont) +
+		m_glyphs.size() * (sizeof(std::pair<const sf::Uint32, Glyph>) + sizeof(void*) * 2u) +
+		m_kernings.size() * (sizeof(std::pair<const sf::Uint64, float>) + sizeof(void*) * 2u);
+}
+
+bool Splashentation::SdfFont::priv_build(const std::string& filename, std::vector<sf::Uint8>& atlas, sf::Vector2u& atlasSize)
+{
+	sf::Font font;
+	if (!font.loadFromFile(filename))
+		return false;
+
+	m_glyphs.clear();
+	m_kernings.clear();
+	m_lineSpacing = font.getLineSpacing(baseSize);
+
+	// rasterize every glyph before reading the glyph page (the page can be resized while glyphs are added)
+	const std::vector<sf::Uint32> codePoints{ getCodePoints() };
+	for (auto& codePoint : codePoints)
+		font.getGlyph(codePoint, baseSize, false);
+	const sf::Image page{ font.getTexture(baseSize).copyToImage() };
+	const sf::Uint8* pagePixels{ page.getPixelsPtr() };
+	const unsigned int pageWidth{ page.getSize().x };
+
+	std::vector<GlyphField> fields;
+	fields.reserve(codePoints.size());
+	for (auto& codePoint : codePoints)
+	{
+		const sf::Glyph& glyph{ font.getGlyph(codePoint, baseSize, false) };
+		Glyph& sdfGlyph{ m_glyphs[codePoint] };
+		sdfGlyph.advance = glyph.advance;
+		sdfGlyph.bounds = { 0.f, 0.f, 0.f, 0.f };
+		sdfGlyph.textureRect = { 0, 0, 0, 0 };
+		if ((glyph.textureRect.width <= 0) || (glyph.textureRect.height <= 0))
+			continue; // whitespace
+		sdfGlyph.bounds = { glyph.bounds.left, glyph.bounds.top, static_cast<float>(glyph.textureRect.width), static_cast<float>(glyph.textureRect.height) };
+
+		GlyphField field{ codePoint, glyph.textureRect.width + spread * 2u, glyph.textureRect.height + spread * 2u, {} };
+		std::vector<bool> isInside(static_cast<std::size_t>(field.width) * field.height, false);
+		for (int y{ 0 }; y < glyph.textureRect.height; ++y)
+		{
+			for (int x{ 0 }; x < glyph.textureRect.width; ++x)
+			{
+				const std::size_t pageIndex{ (static_cast<std::size_t>(glyph.textureRect.top + y) * pageWidth + glyph.textureRect.left + x) * 4u + 3u };
+				isInside[(y + spread) * field.width + x + spread] = (pagePixels[pageIndex] >= 128u);
+			}
+		}
+		field.distances = calculateSignedDistanceField(isInside, field.width, field.height);
+		fields.push_back(std::move(field));
+	}
+
+	// shelf packing (tallest first) into a square-ish power-of-two width
+	std::sort(fields.begin(), fields.end(), [](const GlyphField& a, const GlyphField& b) { return a.height > b.height; });
+	std::size_t area{ 0u };
+	for (auto& field : fields)
+		area += static_cast<std::size_t>(field.width + atlasPadding) * (field.height + atlasPadding);
+	const unsigned int maximumSize{ sf::Texture::getMaximumSize() };
+	unsigned int width{ 256u };
+	while ((static_cast<std::size_t>(width) * width < area) && (width < maximumSize))
+		width *= 2u;
+	unsigned int x{ 0u };
+	unsigned int y{ 0u };
+	unsigned int shelfHeight{ 0u };
+	for (auto& field : fields)
+	{
+		if (x + field.width > width)
+		{
+			x = 0u;
+			y += shelfHeight + atlasPadding;
+			shelfHeight = 0u;
+		}
+		m_glyphs[field.codePoint].textureRect = { static_cast<int>(x), static_cast<int>(y), static_cast<int>(field.width), static_cast<int>(field.height) };
+		x += field.width + atlasPadding;
+		shelfHeight = std::max(shelfHeight, field.height);
+	}
+	atlasSize = { width, std::max(y + shelfHeight, 1u) };
+	if (atlasSize.y > maximumSize)
+		return false;
+
+	atlas.assign(static_cast<std::size_t>(atlasSize.x) * atlasSize.y, 0u);
+	for (auto& field : fields)
+	{
+		const sf::IntRect& textureRect{ m_glyphs[field.codePoint].textureRect };
+		for (unsigned int row{ 0u }; row < field.height; ++row)
+			std::copy(field.distances.begin() + row * field.width, field.distances.begin() + (row + 1u) * field.width, atlas.begin() + (textureRect.top + row) * atlasSize.x + textureRect.left);
+	}
+
+	// kerning is looked up once here so that laying out text never touches the font
+	for (auto& first : codePoints)
+	{
+		for (auto& second : codePoints)
+		{
+			const float kerning{ font.getKerning(first, second, baseSize) };
+			if (kerning != 0.f)
+				m_kernings[getKerningPair(first, second)] = kerning;
+		}
+	}
+	return true;
+}
+
+bool Splashentation::SdfFont::priv_loadCache(const std::string& cacheFilename, std::vector<sf::Uint8>& atlas, sf::Vector2u& atlasSize)
+{
+	std::ifstream file(cacheFilename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+	const std::streamoff fileSize{ file.tellg() };
+	file.seekg(0);
+	CacheHeader header;
+	if ((fileSize < static_cast<std::streamoff>(sizeof(CacheHeader))) || (!readValue(file, header)))
+		return false;
+	if ((std::memcmp(header.magic, cacheMagic, 4u) != 0) ||
+		(header.version != cacheVersion) ||
+		(header.baseSize != baseSize) ||
+		(header.spread != spread) ||
+		(fileSize != static_cast<std::streamoff>(sizeof(CacheHeader) +
+			header.numberOfGlyphs * sizeof(CacheGlyph) +
+			header.numberOfKernings * sizeof(CacheKerning) +
+			static_cast<std::size_t>(header.atlasWidth) * header.atlasHeight)))
+		return false;
+
+	m_glyphs.clear();
+	m_kernings.clear();
+	m_lineSpacing = header.lineSpacing;
+	for (sf::Uint32 i{ 0u }; i < header.numberOfGlyphs; ++i)
+	{
+		CacheGlyph cacheGlyph;
+		if (!readValue(file, cacheGlyph))
+			return false;
+		Glyph& glyph{ m_glyphs[cacheGlyph.codePoint] };
+		glyph.advance = cacheGlyph.advance;
+		glyph.bounds = { cacheGlyph.bounds[0u], cacheGlyph.bounds[1u], cacheGlyph.bounds[2u], cacheGlyph.bounds[3u] };
+		glyph.textureRect = { cacheGlyph.textureRect[0u], cacheGlyph.textureRect[1u], cacheGlyph.textureRect[2u], cacheGlyph.textureRect[3u] };
+	}
+	for (sf::Uint32 i{ 0u }; i < header.numberOfKernings; ++i)
+	{
+		CacheKerning cacheKerning;
+		if (!readValue(file, cacheKerning))
+			return false;
+		m_kernings[cacheKerning.pair] = cacheKerning.kerning;
+	}
+	atlasSize = { header.atlasWidth, header.atlasHeight };
+	atlas.resize(static_cast<std::size_t>(atlasSize.x) * atlasSize.y);
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(atlas.data()), static_cast<std::streamsize>(atlas.size())));
+}
+
+// writes to a temporary file first so that a partially-written cache file is never read
+void Splashentation::SdfFont::priv_saveCache(const std::string& cacheFilename, const std::vector<sf::Uint8>& atlas, const sf::Vector2u atlasSize) const
+{
+	CacheHeader header;
+	std::memset(&header, 0, sizeof(CacheHeader));
+	std::memcpy(header.magic, cacheMagic, 4u);
+	header.version = cacheVersion;
+	header.baseSize = baseSize;
+	header.spread = spread;
+	header.numberOfGlyphs = static_cast<sf::Uint32>(m_glyphs.size());
+	header.numberOfKernings = static_cast<sf::Uint32>(m_kernings.size());
+	header.atlasWidth = atlasSize.x;
+	header.atlasHeight = atlasSize.y;
+	header.lineSpacing = m_lineSpacing;
+
+	const std::string temporaryFilename{ cacheFilename + ".tmp" };
+	{
+		std::ofstream file(temporaryFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return;
+		writeValue(file, header);
+		for (auto& glyph : m_glyphs)
+		{
+			CacheGlyph cacheGlyph;
+			cacheGlyph.codePoint = glyph.first;
+			cacheGlyph.advance = glyph.second.advance;
+			cacheGlyph.bounds[0u] = glyph.second.bounds.left;
+			cacheGlyph.bounds[1u] = glyph.second.bounds.top;
+			cacheGlyph.bounds[2u] = glyph.second.bounds.width;
+			cacheGlyph.bounds[3u] = glyph.second.bounds.height;
+			cacheGlyph.textureRect[0u] = glyph.second.textureRect.left;
+			cacheGlyph.textureRect[1u] = glyph.second.textureRect.top;
+			cacheGlyph.textureRect[2u] = glyph.second.textureRect.width;
+			cacheGlyph.textureRect[3u] = glyph.second.textureRect.height;
+			writeValue(file, cacheGlyph);
+		}
+		for (auto& kerning : m_kernings)
+			writeValue(file, CacheKerning{ kerning.first, kerning.second, 0u });
+		file.write(reinterpret_cast<const char*>(atlas.data()), static_cast<std::streamsize>(atlas.size()));
+		if (!file)
+		{
+			file.close();
+			std::remove(temporaryFilename.c_str());
+			return;
+		}
+	}
+	std::remove(cacheFilename.c_str()); // rename does not replace existing files on all platforms
+	if (std::rename(temporaryFilename.c_str(), cacheFilename.c_str()) != 0)
+		std::remove(temporaryFilename.c_str());
+}
+
+bool Splashentation::SdfFont::priv_createTexture(const std::vector<sf::Uint8>& atlas, const sf::Vector2u atlasSize)
+{
+	m_shader.reset();
+	if (sf::Shader::isAvailable())
+	{
+		m_shader.reset(new sf::Shader);
+		if (m_shader->loadFromMemory(fragmentShader, sf::Shader::Fragment))
+			m_shader->setUniform("texture", sf::Shader::CurrentTexture);
+		else
+			m_shader.reset();
+	}
+
+	// without a shader the field is resolved to coverage now; it then scales like an ordinary (smooth) texture
+	std::vector<sf::Uint8> pixels(atlas.size() * 4u, 255u);
+	for (std::size_t i{ 0u }; i < atlas.size(); ++i)
+		pixels[i * 4u + 3u] = (m_shader != nullptr) ? atlas[i] : convertDistanceToCoverage(atlas[i]);
+	if (!m_texture.create(atlasSize.x, atlasSize.y))
+		return false;
+	m_texture.update(pixels.data());
+	m_texture.setSmooth(true);
+	return true;
+}
+
+
+
+Splashentation::SdfText::SdfText()
+	: m_string()
+	, m_font(nullptr)
+	, m_characterSize(30.f)
+	, m_fillColor(sf::Color::White)
+	, m_vertices(sf::Triangles)
+	, m_bounds()
+{
+}
+
+Splashentation::SdfText::SdfText(const sf::String& string, const SdfFont& font, const float characterSize)
+	: m_string(string)
+	, m_font(&font)
+	, m_characterSize(characterSize)
+	, m_fillColor(sf::Color::White)
+	, m_vertices(sf::Triangles)
+	, m_bounds()
+{
+	priv_updateGeometry();
+}
+
+void Splashentation::SdfText::setString(const sf::String& string)
+{
+	m_string = string;
+	priv_updateGeometry();
+}
+
+void Splashentation::SdfText::setFont(const SdfFont& font)
+{
+	m_font = &font;
+	priv_updateGeometry();
+}
+
+void Splashentation::SdfText::setCharacterSize(const float characterSize)
+{
+	m_characterSize = characterSize;
+	priv_updateGeometry();
+}
+
+void Splashentation::SdfText::setFillColor(const sf::Color& color)
+{
+	m_fillColor = color;
+	for (std::size_t i{ 0u }; i < m_vertices.getVertexCount(); ++i)
+		m_vertices[i].color = color;
+}
+
+const sf::String& Splashentation::SdfText::getString() const
+{
+	return m_string;
+}
+
+const Splashentation::SdfFont* Splashentation::SdfText::getFont() const
+{
+	return m_font;
+}
+
+float Splashentation::SdfText::getCharacterSize() const
+{
+	return m_characterSize;
+}
+
+const sf::Color& Splashentation::SdfText::getFillColor() const
+{
+	return m_fillColor;
+}
+
+sf::FloatRect Splashentation::SdfText::getLocalBounds() const
+{
+	return m_bounds;
+}
+
+sf::FloatRect Splashentation::SdfText::getGlobalBounds() const
+{
+	return getTransform().transformRect(m_bounds);
+}
+
+std::size_t Splashentation::SdfText::getVertexCount() const
+{
+	return m_vertices.getVertexCount();
+}
+
+void Splashentation::SdfText::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if ((m_font == nullptr) || (m_vertices.getVertexCount() == 0u))
+		return;
+
+	states.transform *= getTransform();
+	states.texture = &m_font->getTexture();
+	states.shader = m_font->getShader();
+	target.draw(m_vertices, states);
+}
+
+// laid out like sf::Text (first baseline at the character size)
+void Splashentation::SdfText::priv_updateGeometry()
+{
+	m_vertices.clear();
+	m_bounds = { 0.f, 0.f, 0.f, 0.f };
+	if (m_font == nullptr)
+		return;
+
+	const float scale{ m_characterSize / m_font->getBaseSize() };
+	const float padding{ m_font->getSpread() };
+	const SdfFont::Glyph* space{ m_font->getGlyph(U' ') };
+	const float spaceAdvance{ (space != nullptr) ? space->advance * scale : 0.f };
+	const SdfFont::Glyph* replacement{ m_font->getGlyph(U'?') };
+	float x{ 0.f };
+	float y{ m_characterSize };
+	float minimumX{ 0.f };
+	float minimumY{ 0.f };
+	float maximumX{ 0.f };
+	float maximumY{ 0.f };
+	bool hasBounds{ false };
+	sf::Uint32 previousCodePoint{ 0u };
+	for (std::size_t i{ 0u }; i < m_string.getSize(); ++i)
+	{
+		const sf::Uint32 codePoint{ m_string[i] };
+		if (previousCodePoint != 0u)
+			x += m_font->getKerning(previousCodePoint, codePoint) * scale;
+		previousCodePoint = codePoint;
+
+		if (codePoint == U'\n')
+		{
+			x = 0.f;
+			y += m_font->getLineSpacing() * scale;
+			previousCodePoint = 0u;
+			continue;
+		}
+		if (codePoint == U'\t')
+		{
+			x += spaceAdvance * 4.f;
+			continue;
+		}
+		const SdfFont::Glyph* glyph{ m_font->getGlyph(codePoint) };
+		if (glyph == nullptr)
+			glyph = replacement;
+		if (glyph == nullptr)
+			continue;
+
+		if (glyph->textureRect.width > 0)
+		{
+			const float left{ x + glyph->bounds.left * scale };
+			const float top{ y + glyph->bounds.top * scale };
+			const float right{ left + glyph->bounds.width * scale };
+			const float bottom{ top + glyph->bounds.height * scale };
+
+			// quads extend into the spread so the field fades out fully
+			const sf::FloatRect quad{ left - padding * scale, top - padding * scale, right - left + padding * 2.f * scale, bottom - top + padding * 2.f * scale };
+			const sf::IntRect& textureRect{ glyph->textureRect };
+			const sf::Vector2f topLeft{ quad.left, quad.top };
+			const sf::Vector2f topRight{ quad.left + quad.width, quad.top };
+			const sf::Vector2f bottomLeft{ quad.left, quad.top + quad.height };
+			const sf::Vector2f bottomRight{ quad.left + quad.width, quad.top + quad.height };
+			const sf::Vector2f textureTopLeft{ static_cast<float>(textureRect.left), static_cast<float>(textureRect.top) };
+			const sf::Vector2f textureTopRight{ static_cast<float>(textureRect.left + textureRect.width), static_cast<float>(textureRect.top) };
+			const sf::Vector2f textureBottomLeft{ static_cast<float>(textureRect.left), static_cast<float>(textureRect.top + textureRect.height) };
+			const sf::Vector2f textureBottomRight{ static_cast<float>(textureRect.left + textureRect.width), static_cast<float>(textureRect.top + textureRect.height) };
+			m_vertices.append(sf::Vertex(topLeft, m_fillColor, textureTopLeft));
+			m_vertices.append(sf::Vertex(topRight, m_fillColor, textureTopRight));
+			m_vertices.append(sf::Vertex(bottomLeft, m_fillColor, textureBottomLeft));
+			m_vertices.append(sf::Vertex(bottomLeft, m_fillColor, textureBottomLeft));
+			m_vertices.append(sf::Vertex(topRight, m_fillColor, textureTopRight));
+			m_vertices.append(sf::Vertex(bottomRight, m_fillColor, textureBottomRight));
+
+			minimumX = hasBounds ? std::min(minimumX, left) : left;
+			minimumY = hasBounds ? std::min(minimumY, top) : top;
+			maximumX = hasBounds ? std::max(maximumX, right) : right;
+			maximumY = hasBounds ? std::max(maximumY, bottom) : bottom;
+			hasBounds = true;
+		}
+		x += glyph->advance * scale;
+	}
+	if (hasBounds)
+		m_bounds = { minimumX, minimumY, maximumX - minimumX, maximumY - minimumY };
+}
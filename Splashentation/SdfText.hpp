@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#ifndef SPLASHENTATION_SDFTEXT_HPP
+#define SPLASHENTATION_SDFTEXT_HPP
+
+#include "Standard.hpp"
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+// a font rasterized once (at a single base size) into a signed distance field atlas.
+// the atlas can be cached to disk so that later runs skip rasterization completely
+class Splashentation::SdfFont
+{
+public:
+	struct Glyph
+	{
+		float advance; // at base size
+		sf::FloatRect bounds; // at base size, relative to the baseline
+		sf::IntRect textureRect; // includes the distance field spread around the bounds
+	};
+
+	SdfFont();
+	SdfFont(SdfFont&& font) = default;
+	SdfFont& operator=(SdfFont&& font) = default;
+	SdfFont(const SdfFont&) = delete;
+	SdfFont& operator=(const SdfFont&) = delete;
+
+	bool loadFromFile(const std::string& filename, const std::string& cacheFilename = "", const std::function<bool(std::size_t)>& isAffordable = nullptr); // an empty cache filename disables the cache. isAffordable is given the memory (in bytes) the font needs before its atlas texture is created and can refuse the load
+	const Glyph* getGlyph(sf::Uint32 codePoint) const; // null if the code point is not in the atlas
+	float getKerning(sf::Uint32 first, sf::Uint32 second) const; // at base size
+	float getLineSpacing() const; // at base size
+	float getBaseSize() const;
+	float getSpread() const; // distance (in pixels at base size) covered by the field outside of the glyph bounds
+	const sf::Texture& getTexture() const;
+	const sf::Shader* getShader() const; // null if shaders are not available (the atlas then holds coverage instead of distance)
+	std::size_t getMetricsMemory() const; // glyph and kerning tables
+
+private:
+	std::unordered_map<sf::Uint32, Glyph> m_glyphs;
+	std::unordered_map<sf::Uint64, float> m_kernings; // first code point in the high 32 bits
+	float m_lineSpacing;
+	sf::Texture m_texture;
+	std::unique_ptr<sf::Shader> m_shader;
+
+	bool priv_build(const std::string& filename, std::vector<sf::Uint8>& atlas, sf::Vector2u& atlasSize);
+	bool priv_loadCache(const std::string& cacheFilename, std::vector<sf::Uint8>& atlas, sf::Vector2u& atlasSize);
+	void priv_saveCache(const std::string& cacheFilename, const std::vector<sf::Uint8>& atlas, sf::Vector2u atlasSize) const;
+	bool priv_createTexture(const std::vector<sf::Uint8>& atlas, sf::Vector2u atlasSize);
+};
+
+// text drawn from an sdf font. any character size and scale uses the same atlas so no glyphs are rasterized while drawing
+class Splashentation::SdfText : public sf::Drawable, public sf::Transformable
+{
+public:
+	SdfText();
+	SdfText(const sf::String& string, const SdfFont& font, float characterSize = 30.f);
+
+	void setString(const sf::String& string);
+	void setFont(const SdfFont& font);
+	void setCharacterSize(float characterSize);
+	void setFillColor(const sf::Color& color);
+	const sf::String& getString() const;
+	const SdfFont* getFont() const;
+	float getCharacterSize() const;
+	const sf::Color& getFillColor() const;
+	sf::FloatRect getLocalBounds() const;
+	sf::FloatRect getGlobalBounds() const;
+	std::size_t getVertexCount() const;
+
+private:
+	sf::String m_string;
+	const SdfFont* m_font;
+	float m_characterSize;
+	sf::Color m_fillColor;
+	sf::VertexArray m_vertices;
+	sf::FloatRect m_bounds;
+
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+	void priv_updateGeometry();
+};
+
+#endif // SPLASHENTATION_SDFTEXT_HPP
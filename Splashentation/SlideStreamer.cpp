@@ -0,0 +1,188 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "SlideStreamer.hpp"
+
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Font.hpp>
+
+Splashentation::SlideStreamer::SlideStreamer(SlideSource& slideSource, const std::size_t numberOfSlidesAhead, const std::function<void()>& threadSetup)
+	: m_slideSource(slideSource)
+	, m_threadSetup(threadSetup)
+	, m_numberOfSlides(slideSource.getNumberOfSlides())
+	, m_numberOfSlidesAhead(numberOfSlidesAhead)
+	, m_loadedSlides()
+	, m_internedSlideControls()
+	, m_currentSlideIndex(0u)
+	, m_isStopping(false)
+{
+	m_thread = std::thread(&SlideStreamer::t_load, this);
+}
+
+Splashentation::SlideStreamer::~SlideStreamer()
+{
+	stop();
+}
+
+std::size_t Splashentation::SlideStreamer::getNumberOfSlides() const
+{
+	return m_numberOfSlides;
+}
+
+void Splashentation::SlideStreamer::setCurrentSlide(const std::size_t index)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	if (index == m_currentSlideIndex)
+		return;
+	m_currentSlideIndex = index;
+	m_condition.notify_one();
+}
+
+const Splashentation::CompactSlide* Splashentation::SlideStreamer::getSlide(const std::size_t index) const
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	const std::map<std::size_t, std::unique_ptr<LoadedSlide>>::const_iterator loadedSlide{ m_loadedSlides.find(index) };
+	return (loadedSlide == m_loadedSlides.end()) ? nullptr : &loadedSlide->second->slide;
+}
+
+void Splashentation::SlideStreamer::forEachLoadedSlide(const std::function<void(const LoadedSlide&)>& function) const
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	for (auto& loadedSlide : m_loadedSlides)
+		function(*loadedSlide.second);
+}
+
+void Splashentation::SlideStreamer::stop()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		m_isStopping = true;
+		m_condition.notify_one();
+	}
+	if (m_thread.joinable())
+		m_thread.join();
+
+	std::map<std::size_t, std::unique_ptr<LoadedSlide>> releasedSlides;
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		releasedSlides.swap(m_loadedSlides);
+	}
+}
+
+void Splashentation::SlideStreamer::t_load()
+{
+	if (m_threadSetup)
+		m_threadSetup();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_isStopping)
+	{
+		// slides that have been left are released and the most needed missing slide is loaded (both outside of the lock)
+		std::vector<std::unique_ptr<LoadedSlide>> releasedSlides;
+		for (std::map<std::size_t, std::unique_ptr<LoadedSlide>>::iterator loadedSlide{ m_loadedSlides.begin() }; loadedSlide != m_loadedSlides.end();)
+		{
+			if (priv_isWanted(loadedSlide->first))
+				++loadedSlide;
+			else
+			{
+				releasedSlides.push_back(std::move(loadedSlide->second));
+				loadedSlide = m_loadedSlides.erase(loadedSlide);
+			}
+		}
+		std::size_t index;
+		const bool isLoadNeeded{ priv_findSlideToLoad(index) };
+		if ((releasedSlides.empty()) && (!isLoadNeeded))
+		{
+			m_condition.wait(lock);
+			continue;
+		}
+
+		lock.unlock();
+		releasedSlides.clear();
+		std::unique_ptr<LoadedSlide> loadedSlide;
+		if (isLoadNeeded)
+			loadedSlide = priv_loadSlide(index);
+		lock.lock();
+
+		if ((loadedSlide) && (priv_isWanted(index)))
+			m_loadedSlides[index] = std::move(loadedSlide);
+		else if (loadedSlide)
+		{
+			// current slide moved on while loading
+			lock.unlock();
+			loadedSlide.reset();
+			lock.lock();
+		}
+	}
+}
+
+bool Splashentation::SlideStreamer::priv_isWanted(const std::size_t index) const
+{
+	return (index + 1u >= m_currentSlideIndex) && (index <= m_currentSlideIndex + m_numberOfSlidesAhead) && (index < m_numberOfSlides);
+}
+
+bool Splashentation::SlideStreamer::priv_findSlideToLoad(std::size_t& index) const
+{
+	// current slide first, then the slides ahead (in order) and then the slide before
+	for (std::size_t offset{ 0u }; offset <= m_numberOfSlidesAhead; ++offset)
+	{
+		index = m_currentSlideIndex + offset;
+		if (index >= m_numberOfSlides)
+			break;
+		if (m_loadedSlides.count(index) == 0)
+			return true;
+	}
+	if (m_currentSlideIndex > 0u)
+	{
+		index = m_currentSlideIndex - 1u;
+		return (m_loadedSlides.count(index) == 0);
+	}
+	return false;
+}
+
+std::unique_ptr<Splashentation::SlideStreamer::LoadedSlide> Splashentation::SlideStreamer::priv_loadSlide(const std::size_t index)
+{
+	SlideContent content;
+	try
+	{
+		m_slideSource.loadSlide(index, content);
+	}
+	catch (...)
+	{
+		content = SlideContent();
+	}
+
+	std::unique_ptr<LoadedSlide> loadedSlide(new LoadedSlide);
+	loadedSlide->slide = priv_compactSlide(std::move(content.slide), m_internedSlideControls);
+	loadedSlide->slide.drawables = std::move(content.drawables);
+	loadedSlide->textures = std::move(content.textures);
+	loadedSlide->fonts = std::move(content.fonts);
+	return loadedSlide;
+}
@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef SPLASHENTATION_SLIDESTREAMER_HPP
+#define SPLASHENTATION_SLIDESTREAMER_HPP
+
+#include "Standard.hpp"
+
+#include <map>
+
+// keeps the slides around the current slide loaded from a slide source (on its own thread) and releases the others.
+// the slide before the current one is kept for its transition; slides ahead are loaded in order of need
+class Splashentation::SlideStreamer
+{
+public:
+	struct LoadedSlide
+	{
+		CompactSlide slide;
+		std::vector<std::unique_ptr<sf::Texture>> textures;
+		std::vector<std::unique_ptr<sf::Font>> fonts;
+	};
+
+	SlideStreamer(SlideSource& slideSource, std::size_t numberOfSlidesAhead, const std::function<void()>& threadSetup = nullptr); // thread setup is run at the start of the loading thread
+	~SlideStreamer();
+
+	std::size_t getNumberOfSlides() const;
+	void setCurrentSlide(std::size_t index);
+	const CompactSlide* getSlide(std::size_t index) const; // null if the slide is not loaded. valid until the current slide moves beyond it
+	void forEachLoadedSlide(const std::function<void(const LoadedSlide&)>& function) const;
+	void stop(); // stops loading and releases all slides
+
+private:
+	SlideSource& m_slideSource;
+	const std::function<void()> m_threadSetup;
+	const std::size_t m_numberOfSlides;
+	const std::size_t m_numberOfSlidesAhead;
+	std::map<std::size_t, std::unique_ptr<LoadedSlide>> m_loadedSlides;
+	InternedSlideControls m_internedSlideControls; // only used by the loading thread
+	std::size_t m_currentSlideIndex;
+	bool m_isStopping;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::thread m_thread;
+
+	void t_load();
+
+	bool priv_isWanted(std::size_t index) const; // requires m_mutex
+	bool priv_findSlideToLoad(std::size_t& index) const; // requires m_mutex
+	std::unique_ptr<LoadedSlide> priv_loadSlide(std::size_t index);
+};
+
+#endif // SPLASHENTATION_SLIDESTREAMER_HPP
@@ -0,0 +1,253 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include "SoftwareCompositor.hpp"
+
+#include <cstring> // for std::memcpy
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SPLASHENTATION_SOFTWARECOMPOSITOR_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif // defined(_MSC_VER)
+#endif // x86
+
+#if defined(SPLASHENTATION_SOFTWARECOMPOSITOR_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SPLASHENTATION_TARGET_SSE2 __attribute__((target("sse2")))
+#define SPLASHENTATION_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SPLASHENTATION_TARGET_SSE2
+#define SPLASHENTATION_TARGET_AVX2
+#endif
+
+namespace
+{
+
+// all kernels work on 32-bit RGBA pixels. alpha is fixed-point (0 - 256)
+
+void fillScalar(sf::Uint8* destination, const std::size_t numberOfPixels, const sf::Uint32 color)
+{
+	for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+		std::memcpy(destination + i * 4u, &color, 4u);
+}
+
+void blendScalar(sf::Uint8* destination, const sf::Uint8* source, const std::size_t numberOfPixels, const unsigned int alpha)
+{
+	for (std::size_t i{ 0u }; i < numberOfPixels; ++i, destination += 4u, source += 4u)
+	{
+		const unsigned int pixelAlpha{ (source[3u] * alpha + 128u) >> 8u };
+		const unsigned int weight{ pixelAlpha + (pixelAlpha >> 7u) }; // 0 - 255 to 0 - 256
+		for (unsigned int c{ 0u }; c < 4u; ++c)
+			destination[c] = static_cast<sf::Uint8>((source[c] * weight + destination[c] * (256u - weight)) >> 8u);
+	}
+}
+
+#ifdef SPLASHENTATION_SOFTWARECOMPOSITOR_X86
+
+SPLASHENTATION_TARGET_SSE2 void fillSse2(sf::Uint8* destination, const std::size_t numberOfPixels, const sf::Uint32 color)
+{
+	const __m128i colors{ _mm_set1_epi32(static_cast<int>(color)) };
+	std::size_t i{ 0u };
+	for (; i + 4u <= numberOfPixels; i += 4u)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4u), colors);
+	fillScalar(destination + i * 4u, numberOfPixels - i, color);
+}
+
+// blends two pixels held in 16-bit lanes
+SPLASHENTATION_TARGET_SSE2 inline __m128i blendTwoPixelsSse2(const __m128i source, const __m128i destination, const __m128i alpha)
+{
+	// per-pixel weight: (sourceAlpha * alpha + 128) >> 8, then scaled from 0 - 255 to 0 - 256
+	__m128i weight{ _mm_shufflehi_epi16(_mm_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)) };
+	weight = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(weight, alpha), _mm_set1_epi16(128)), 8);
+	weight = _mm_add_epi16(weight, _mm_srli_epi16(weight, 7));
+	const __m128i inverseWeight{ _mm_sub_epi16(_mm_set1_epi16(256), weight) };
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(source, weight), _mm_mullo_epi16(destination, inverseWeight)), 8);
+}
+
+SPLASHENTATION_TARGET_SSE2 void blendSse2(sf::Uint8* destination, const sf::Uint8* source, const std::size_t numberOfPixels, const unsigned int alpha)
+{
+	const __m128i zero{ _mm_setzero_si128() };
+	const __m128i alphas{ _mm_set1_epi16(static_cast<short>(alpha)) };
+	std::size_t i{ 0u };
+	for (; i + 4u <= numberOfPixels; i += 4u)
+	{
+		const __m128i sourcePixels{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4u)) };
+		const __m128i destinationPixels{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i * 4u)) };
+		const __m128i low{ blendTwoPixelsSse2(_mm_unpacklo_epi8(sourcePixels, zero), _mm_unpacklo_epi8(destinationPixels, zero), alphas) };
+		const __m128i high{ blendTwoPixelsSse2(_mm_unpackhi_epi8(sourcePixels, zero), _mm_unpackhi_epi8(destinationPixels, zero), alphas) };
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4u), _mm_packus_epi16(low, high));
+	}
+	blendScalar(destination + i * 4u, source + i * 4u, numberOfPixels - i, alpha);
+}
+
+SPLASHENTATION_TARGET_AVX2 void fillAvx2(sf::Uint8* destination, const std::size_t numberOfPixels, const sf::Uint32 color)
+{
+	const __m256i colors{ _mm256_set1_epi32(static_cast<int>(color)) };
+	std::size_t i{ 0u };
+	for (; i + 8u <= numberOfPixels; i += 8u)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4u), colors);
+	fillScalar(destination + i * 4u, numberOfPixels - i, color);
+}
+
+SPLASHENTATION_TARGET_AVX2 inline __m256i blendFourPixelsAvx2(const __m256i source, const __m256i destination, const __m256i alpha)
+{
+	__m256i weight{ _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)) };
+	weight = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(weight, alpha), _mm256_set1_epi16(128)), 8);
+	weight = _mm256_add_epi16(weight, _mm256_srli_epi16(weight, 7));
+	const __m256i inverseWeight{ _mm256_sub_epi16(_mm256_set1_epi16(256), weight) };
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(source, weight), _mm256_mullo_epi16(destination, inverseWeight)), 8);
+}
+
+SPLASHENTATION_TARGET_AVX2 void blendAvx2(sf::Uint8* destination, const sf::Uint8* source, const std::size_t numberOfPixels, const unsigned int alpha)
+{
+	// unpacking and packing both work within 128-bit lanes so pixel order is preserved
+	const __m256i zero{ _mm256_setzero_si256() };
+	const __m256i alphas{ _mm256_set1_epi16(static_cast<short>(alpha)) };
+	std::size_t i{ 0u };
+	for (; i + 8u <= numberOfPixels; i += 8u)
+	{
+		const __m256i sourcePixels{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4u)) };
+		const __m256i destinationPixels{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination + i * 4u)) };
+		const __m256i low{ blendFourPixelsAvx2(_mm256_unpacklo_epi8(sourcePixels, zero), _mm256_unpacklo_epi8(destinationPixels, zero), alphas) };
+		const __m256i high{ blendFourPixelsAvx2(_mm256_unpackhi_epi8(sourcePixels, zero), _mm256_unpackhi_epi8(destinationPixels, zero), alphas) };
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4u), _mm256_packus_epi16(low, high));
+	}
+	blendScalar(destination + i * 4u, source + i * 4u, numberOfPixels - i, alpha);
+}
+
+bool isAvx2Supported()
+{
+#if defined(_MSC_VER)
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 7)
+		return false;
+	__cpuid(cpuInfo, 1);
+	const bool isOsxsaveSupported{ (cpuInfo[2] & (1 << 27)) != 0 };
+	const bool isAvxSupported{ (cpuInfo[2] & (1 << 28)) != 0 };
+	if ((!isOsxsaveSupported) || (!isAvxSupported) || ((_xgetbv(0) & 0x6) != 0x6))
+		return false;
+	__cpuidex(cpuInfo, 7, 0);
+	return (cpuInfo[1] & (1 << 5)) != 0;
+#else // defined(_MSC_VER)
+	return __builtin_cpu_supports("avx2") != 0;
+#endif // defined(_MSC_VER)
+}
+
+bool isSse2Supported()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+	return true;
+#elif defined(_MSC_VER)
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 1);
+	return (cpuInfo[3] & (1 << 26)) != 0;
+#else
+	return __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+
+#endif // SPLASHENTATION_SOFTWARECOMPOSITOR_X86
+
+struct Kernels
+{
+	void(*fill)(sf::Uint8*, std::size_t, sf::Uint32);
+	void(*blend)(sf::Uint8*, const sf::Uint8*, std::size_t, unsigned int);
+	const char* name;
+};
+
+Kernels chooseKernels()
+{
+#ifdef SPLASHENTATION_SOFTWARECOMPOSITOR_X86
+	if (isAvx2Supported())
+		return{ fillAvx2, blendAvx2, "AVX2" };
+	if (isSse2Supported())
+		return{ fillSse2, blendSse2, "SSE2" };
+#endif // SPLASHENTATION_SOFTWARECOMPOSITOR_X86
+	return{ fillScalar, blendScalar, "scalar" };
+}
+
+const Kernels& getKernels()
+{
+	static const Kernels kernels{ chooseKernels() };
+	return kernels;
+}
+
+} // namespace
+
+Splashentation::SoftwareCompositor::SoftwareCompositor()
+	: m_size()
+	, m_pixels()
+{
+}
+
+void Splashentation::SoftwareCompositor::setSize(const sf::Vector2u size)
+{
+	m_size = size;
+	m_pixels.resize(static_cast<std::size_t>(size.x) * size.y * 4u);
+}
+
+sf::Vector2u Splashentation::SoftwareCompositor::getSize() const
+{
+	return m_size;
+}
+
+void Splashentation::SoftwareCompositor::clear(const sf::Color color)
+{
+	const sf::Uint8 bytes[4]{ color.r, color.g, color.b, color.a };
+	sf::Uint32 packedColor;
+	std::memcpy(&packedColor, bytes, 4u);
+	getKernels().fill(m_pixels.data(), m_pixels.size() / 4u, packedColor);
+}
+
+void Splashentation::SoftwareCompositor::copy(const sf::Uint8* const pixels)
+{
+	std::memcpy(m_pixels.data(), pixels, m_pixels.size());
+}
+
+void Splashentation::SoftwareCompositor::blend(const sf::Uint8* const pixels, float alpha)
+{
+	if (alpha < 0.f)
+		alpha = 0.f;
+	else if (alpha > 1.f)
+		alpha = 1.f;
+	getKernels().blend(m_pixels.data(), pixels, m_pixels.size() / 4u, static_cast<unsigned int>(alpha * 256.f));
+}
+
+const sf::Uint8* Splashentation::SoftwareCompositor::getPixels() const
+{
+	return m_pixels.data();
+}
+
+const char* Splashentation::SoftwareCompositor::getKernelName()
+{
+	return getKernels().name;
+}
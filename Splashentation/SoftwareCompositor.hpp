@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SPLASHENTATION_SOFTWARECOMPOSITOR_HPP
+#define SPLASHENTATION_SOFTWARECOMPOSITOR_HPP
+
+#include "Standard.hpp"
+
+// CPU framebuffer (RGBA) for composing cached slide images without relying on (possibly software-emulated) GL blending.
+// kernels use AVX2 or SSE2 when the processor supports them (chosen at runtime) and fall back to scalar code otherwise.
+class Splashentation::SoftwareCompositor
+{
+public:
+	SoftwareCompositor();
+
+	void setSize(sf::Vector2u size);
+	sf::Vector2u getSize() const;
+	void clear(sf::Color color);
+	void copy(const sf::Uint8* pixels);
+	void blend(const sf::Uint8* pixels, float alpha); // source-over using each source pixel's alpha multiplied by alpha
+	const sf::Uint8* getPixels() const;
+
+	static const char* getKernelName();
+
+private:
+	sf::Vector2u m_size;
+	std::vector<sf::Uint8> m_pixels;
+};
+
+#endif // SPLASHENTATION_SOFTWARECOMPOSITOR_HPP
@@ -28,6 +28,17 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "Standard.hpp"
+#include "LoadingScheduler.hpp"
+#include "FramePreparer.hpp"
+#include "SoftwareCompositor.hpp"
+#include "SlideStreamer.hpp"
+#include "Trace.hpp"
+#include "SdfText.hpp"
+#include "ProgressiveTextureLoader.hpp"
+#include "RemoteChannel.hpp"
+#include "RegionIndex.hpp"
+#include "SteadyTime.hpp"
+#include "ContentionTrackingMutex.hpp"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Window/Event.hpp>
@@ -36,473 +47,2726 @@
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Sleep.hpp>
 
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm> // for std::find
+#include <fstream>
+#include <cstdio> // for std::rename and std::remove
+#include <cstring> // for std::memcmp and std::memcpy
+#include <deque>
+#include <cmath> // for std::ceil
+#include <ctime> // for clock_gettime
+#include <sys/stat.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPLASHENTATION_DECODED_IMAGE_CACHE_MMAP
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#if defined(__linux__)
+#define SPLASHENTATION_RENDER_THREAD_SCHEDULING
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif // defined(__linux__)
 
 namespace
 {
 
 std::mutex resourceMutex;
 std::unordered_map<std::string, sf::Font> fonts;
+std::unordered_map<std::string, Splashentation::SdfFont> sdfFonts;
 std::unordered_map<std::string, sf::Texture> textures;
 
+std::unordered_map<std::string, std::size_t> fontSourceSizes; // font file sizes (font data is kept in memory while loaded)
+std::unordered_set<const sf::Texture*> opaqueTextures; // loaded textures known to have no transparent pixels
+std::unordered_set<std::string> evictableTextures; // names of resources that the memory budget may remove
+std::unordered_set<std::string> evictableFonts;
+std::unordered_set<std::string> evictableSdfFonts;
+
+using SplashentationInternal::getSteadyTimeInMicroseconds;
+
+
+
+// decoded image cache
+
+// cache files are a fixed-size header followed immediately by tightly-packed RGBA pixels.
+// the header is padded to 64 bytes so that the pixels are suitably aligned when the file is memory-mapped.
+const char decodedImageCacheMagic[4]{ 'S', 'P', 'D', 'C' };
+const sf::Uint32 decodedImageCacheVersion{ 1u };
+
+struct DecodedImageCacheHeader
+{
+	char magic[4];
+	sf::Uint32 version;
+	sf::Uint32 width;
+	sf::Uint32 height;
+	sf::Uint64 sourceSize;
+	sf::Int64 sourceModificationTime;
+	sf::Uint64 sourceFilenameHash;
+	sf::Uint32 maximumSize;
+	sf::Uint8 padding[20];
+};
+static_assert(sizeof(DecodedImageCacheHeader) == 64u, "Decoded image cache header must be 64 bytes");
+
+sf::Uint64 hashString(const std::string& string)
+{
+	// FNV-1a
+	sf::Uint64 hash{ 14695981039346656037ull };
+	for (const char c : string)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool getSourceFileInformation(const std::string& filename, sf::Uint64& size, sf::Int64& modificationTime)
+{
+	struct stat fileStatus;
+	if (stat(filename.c_str(), &fileStatus) != 0)
+		return false;
+	size = static_cast<sf::Uint64>(fileStatus.st_size);
+	modificationTime = static_cast<sf::Int64>(fileStatus.st_mtime);
+	return true;
+}
+
+std::string getCacheFilename(const std::string& directory, const sf::Uint64 hash, const std::string& extension)
+{
+	const char hexDigits[]{ "0123456789abcdef" };
+	std::string filename(16u, '0');
+	for (unsigned int i{ 0u }; i < 16u; ++i)
+		filename[15u - i] = hexDigits[(hash >> (i * 4u)) & 0xFu];
+	return directory + "/" + filename + extension;
+}
+
+std::string getDecodedImageCacheFilename(const std::string& directory, const sf::Uint64 sourceFilenameHash)
+{
+	return getCacheFilename(directory, sourceFilenameHash, ".spdc");
+}
+
+// the source size and modification time are part of the name so a changed font never reuses a stale atlas
+std::string getSdfFontCacheFilename(const std::string& directory, const std::string& filename)
+{
+	sf::Uint64 sourceSize;
+	sf::Int64 sourceModificationTime;
+	if (!getSourceFileInformation(filename, sourceSize, sourceModificationTime))
+		return "";
+	return getCacheFilename(directory, hashString(filename + ":" + std::to_string(sourceSize) + ":" + std::to_string(sourceModificationTime)), ".spsd");
+}
+
+bool isDecodedImageCacheHeaderValid(const DecodedImageCacheHeader& header, const DecodedImageCacheHeader& expected, const std::size_t fileSize)
+{
+	return (std::memcmp(header.magic, expected.magic, 4u) == 0) &&
+		(header.version == expected.version) &&
+		(header.sourceSize == expected.sourceSize) &&
+		(header.sourceModificationTime == expected.sourceModificationTime) &&
+		(header.sourceFilenameHash == expected.sourceFilenameHash) &&
+		(header.maximumSize == expected.maximumSize) &&
+		(header.width > 0u) && (header.height > 0u) &&
+		(fileSize == sizeof(DecodedImageCacheHeader) + static_cast<std::size_t>(header.width) * header.height * 4u);
+}
+
+bool createDecodedImageCacheHeader(DecodedImageCacheHeader& header, const char magic[4], const std::string& filename, const unsigned int maximumSize)
+{
+	std::memset(&header, 0, sizeof(DecodedImageCacheHeader));
+	std::memcpy(header.magic, magic, 4u);
+	header.version = decodedImageCacheVersion;
+	header.maximumSize = maximumSize;
+	header.sourceFilenameHash = hashString(filename);
+	return getSourceFileInformation(filename, header.sourceSize, header.sourceModificationTime);
+}
+
+bool arePixelsOpaque(const sf::Uint8* pixels, const std::size_t numberOfPixels)
+{
+	for (std::size_t i{ 0u }; i < numberOfPixels; ++i)
+	{
+		if (pixels[i * 4u + 3u] != 255u)
+			return false;
+	}
+	return true;
+}
+
+bool isImageOpaque(const sf::Image& image)
+{
+	return arePixelsOpaque(image.getPixelsPtr(), static_cast<std::size_t>(image.getSize().x) * image.getSize().y);
+}
+
+bool createFromPixels(sf::Texture& texture, const unsigned int width, const unsigned int height, const sf::Uint8* pixels)
+{
+	if (!texture.create(width, height))
+		return false;
+	texture.update(pixels);
+	return true;
+}
+
+bool createFromPixels(sf::Image& image, const unsigned int width, const unsigned int height, const sf::Uint8* pixels)
+{
+	image.create(width, height, pixels);
+	return true;
+}
+
+template <class resourceT>
+bool createFromDecodedImageCacheData(resourceT& resource, const sf::Uint8* data, const std::size_t dataSize, const DecodedImageCacheHeader& expected, bool* isOpaque)
+{
+	if (dataSize < sizeof(DecodedImageCacheHeader))
+		return false;
+	DecodedImageCacheHeader header;
+	std::memcpy(&header, data, sizeof(DecodedImageCacheHeader));
+	if (!isDecodedImageCacheHeaderValid(header, expected, dataSize))
+		return false;
+	if (isOpaque != nullptr)
+		*isOpaque = arePixelsOpaque(data + sizeof(DecodedImageCacheHeader), static_cast<std::size_t>(header.width) * header.height);
+	return createFromPixels(resource, header.width, header.height, data + sizeof(DecodedImageCacheHeader));
+}
+
+template <class resourceT>
+bool loadFromDecodedImageCache(resourceT& resource, const std::string& cacheFilename, const DecodedImageCacheHeader& expected, bool* isOpaque = nullptr)
+{
+#ifdef SPLASHENTATION_DECODED_IMAGE_CACHE_MMAP
+	const int fileDescriptor{ open(cacheFilename.c_str(), O_RDONLY) };
+	if (fileDescriptor < 0)
+		return false;
+	struct stat fileStatus;
+	if ((fstat(fileDescriptor, &fileStatus) != 0) || (fileStatus.st_size <= 0))
+	{
+		close(fileDescriptor);
+		return false;
+	}
+	const std::size_t fileSize{ static_cast<std::size_t>(fileStatus.st_size) };
+	void* mapping{ mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) };
+	close(fileDescriptor);
+	if (mapping == MAP_FAILED)
+		return false;
+	const bool isLoaded{ createFromDecodedImageCacheData(resource, static_cast<const sf::Uint8*>(mapping), fileSize, expected, isOpaque) };
+	munmap(mapping, fileSize);
+	return isLoaded;
+#else // SPLASHENTATION_DECODED_IMAGE_CACHE_MMAP
+	std::ifstream file(cacheFilename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+	const std::streamoff fileSize{ file.tellg() };
+	if (fileSize <= 0)
+		return false;
+	std::vector<sf::Uint8> data(static_cast<std::size_t>(fileSize));
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char*>(data.data()), fileSize))
+		return false;
+	return createFromDecodedImageCacheData(resource, data.data(), data.size(), expected, isOpaque);
+#endif // SPLASHENTATION_DECODED_IMAGE_CACHE_MMAP
+}
+
+// smallest integer factor that fits within maximumSize
+unsigned int getDownscaleFactor(const sf::Vector2u size, const unsigned int maximumSize)
+{
+	const unsigned int largestSide{ std::max(size.x, size.y) };
+	return ((maximumSize == 0u) || (largestSide <= maximumSize)) ? 1u : (largestSide + maximumSize - 1u) / maximumSize;
+}
+
+sf::Vector2u getDownscaledSize(const sf::Vector2u size, const unsigned int maximumSize)
+{
+	const unsigned int factor{ getDownscaleFactor(size, maximumSize) };
+	return{ std::max(size.x / factor, 1u), std::max(size.y / factor, 1u) };
+}
+
+// box filter by the smallest integer factor that fits the image within maximumSize
+void downscaleImage(sf::Image& image, const unsigned int maximumSize)
+{
+	const sf::Vector2u size{ image.getSize() };
+	const unsigned int factor{ getDownscaleFactor(size, maximumSize) };
+	if (factor == 1u)
+		return;
+
+	const sf::Vector2u newSize{ getDownscaledSize(size, maximumSize) };
+	const sf::Uint8* source{ image.getPixelsPtr() };
+	std::vector<sf::Uint8> pixels(static_cast<std::size_t>(newSize.x) * newSize.y * 4u);
+	for (unsigned int y{ 0u }; y < newSize.y; ++y)
+	{
+		for (unsigned int x{ 0u }; x < newSize.x; ++x)
+		{
+			unsigned int totals[4]{ 0u, 0u, 0u, 0u };
+			unsigned int count{ 0u };
+			for (unsigned int sy{ y * factor }; (sy < (y + 1u) * factor) && (sy < size.y); ++sy)
+			{
+				for (unsigned int sx{ x * factor }; (sx < (x + 1u) * factor) && (sx < size.x); ++sx)
+				{
+					const sf::Uint8* pixel{ source + (static_cast<std::size_t>(sy) * size.x + sx) * 4u };
+					for (unsigned int c{ 0u }; c < 4u; ++c)
+						totals[c] += pixel[c];
+					++count;
+				}
+			}
+			sf::Uint8* destination{ pixels.data() + (static_cast<std::size_t>(y) * newSize.x + x) * 4u };
+			for (unsigned int c{ 0u }; c < 4u; ++c)
+				destination[c] = static_cast<sf::Uint8>(totals[c] / count);
+		}
+	}
+	image.create(newSize.x, newSize.y, pixels.data());
+}
+
+// writes to a temporary file first so that a partially-written cache file is never read
+void saveDecodedImageCache(const sf::Image& image, const std::string& cacheFilename, DecodedImageCacheHeader header)
+{
+	header.width = image.getSize().x;
+	header.height = image.getSize().y;
+	const std::string temporaryFilename{ cacheFilename + ".tmp" };
+	{
+		std::ofstream file(temporaryFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(DecodedImageCacheHeader));
+		file.write(reinterpret_cast<const char*>(image.getPixelsPtr()), static_cast<std::streamsize>(header.width) * header.height * 4u);
+		if (!file)
+		{
+			file.close();
+			std::remove(temporaryFilename.c_str());
+			return;
+		}
+	}
+	std::remove(cacheFilename.c_str()); // rename does not replace existing files on all platforms
+	if (std::rename(temporaryFilename.c_str(), cacheFilename.c_str()) != 0)
+		std::remove(temporaryFilename.c_str());
+}
+
+bool loadTextureUsingDecodedImageCache(sf::Texture& texture, const std::string& filename, const std::string& directory, const unsigned int maximumSize, bool& isOpaque)
+{
+	DecodedImageCacheHeader expected;
+	if (!createDecodedImageCacheHeader(expected, decodedImageCacheMagic, filename, maximumSize))
+		return false;
+
+	// warm: upload directly from the cached pixels
+	const std::string cacheFilename{ getDecodedImageCacheFilename(directory, expected.sourceFilenameHash) };
+	if (loadFromDecodedImageCache(texture, cacheFilename, expected, &isOpaque))
+		return true;
+
+	// cold (or stale): decode the source and (re)write the cache
+	sf::Image image;
+	if (!image.loadFromFile(filename))
+		return false;
+	downscaleImage(image, maximumSize);
+	if (!texture.loadFromImage(image))
+		return false;
+	isOpaque = isImageOpaque(image);
+	saveDecodedImageCache(image, cacheFilename, expected);
+	return true;
+}
+
+// as sf::Texture::loadFromFile (which also decodes to an image first), also reporting whether the image is opaque
+bool loadTextureFromFile(sf::Texture& texture, const std::string& filename, bool& isOpaque)
+{
+	sf::Image image;
+	if ((!image.loadFromFile(filename)) || (!texture.loadFromImage(image)))
+		return false;
+	isOpaque = isImageOpaque(image);
+	return true;
+}
+
+bool loadImageUsingDecodedImageCache(sf::Image& image, const std::string& filename, const std::string& directory, const unsigned int maximumSize)
+{
+	DecodedImageCacheHeader expected;
+	if (!createDecodedImageCacheHeader(expected, decodedImageCacheMagic, filename, maximumSize))
+		return false;
+
+	const std::string cacheFilename{ getDecodedImageCacheFilename(directory, expected.sourceFilenameHash) };
+	if (loadFromDecodedImageCache(image, cacheFilename, expected))
+		return true;
+
+	if (!image.loadFromFile(filename))
+		return false;
+	downscaleImage(image, maximumSize);
+	saveDecodedImageCache(image, cacheFilename, expected);
+	return true;
+}
+
+
+
+
+// progressive loading
+
+const char thumbnailMagic[4]{ 'S', 'P', 'T', 'H' };
+const unsigned int thumbnailSize{ 256u };
+const std::size_t progressiveUploadBytesPerFrame{ 4u * 1024u * 1024u }; // rows of decoded images uploaded each frame
+
+
+
+// remote
+
+const std::size_t remoteChannelCapacity{ 256u * 1024u };
+const sf::Time remoteSendTimeout{ sf::seconds(1.f) }; // a full ring for this long means that the host is not receiving
+const sf::Time remoteExchangeInterval{ sf::milliseconds(10) };
+const sf::Time remoteHostTimeout{ sf::seconds(2.f) }; // a playing host that does not publish a frame for this long has gone
+
+bool loadThumbnail(sf::Image& image, const std::string& filename, const std::string& directory)
+{
+	DecodedImageCacheHeader expected;
+	if (!createDecodedImageCacheHeader(expected, thumbnailMagic, filename, thumbnailSize))
+		return false;
+	return loadFromDecodedImageCache(image, getCacheFilename(directory, expected.sourceFilenameHash, ".spth"), expected);
+}
+
+void saveThumbnail(const sf::Image& image, const std::string& filename, const std::string& directory)
+{
+	DecodedImageCacheHeader header;
+	if (!createDecodedImageCacheHeader(header, thumbnailMagic, filename, thumbnailSize))
+		return;
+	sf::Image thumbnail(image);
+	downscaleImage(thumbnail, thumbnailSize);
+	saveDecodedImageCache(thumbnail, getCacheFilename(directory, header.sourceFilenameHash, ".spth"), header);
+}
+
+sf::Uint32 readBigEndian(const unsigned char* bytes, const unsigned int numberOfBytes)
+{
+	sf::Uint32 value{ 0u };
+	for (unsigned int i{ 0u }; i < numberOfBytes; ++i)
+		value = (value << 8u) | bytes[i];
+	return value;
+}
+
+// reads the next marker segment of a jpeg. fails at the start of the image data
+bool readJpegSegment(std::ifstream& file, unsigned char& marker, std::vector<unsigned char>& segment)
+{
+	unsigned char header[4];
+	if ((!file.read(reinterpret_cast<char*>(header), 4)) || (header[0] != 0xFFu) || (header[1] == 0xDAu) || (header[1] == 0xD9u))
+		return false;
+	const std::size_t length{ readBigEndian(header + 2u, 2u) };
+	if (length < 2u)
+		return false;
+	marker = header[1];
+	segment.resize(length - 2u);
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(segment.data()), static_cast<std::streamsize>(segment.size())));
+}
+
+// png and jpeg sizes are read from their headers without decoding
+bool readImageSize(const std::string& filename, sf::Vector2u& size)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	unsigned char signature[8];
+	if (!file.read(reinterpret_cast<char*>(signature), 8))
+		return false;
+
+	const unsigned char pngSignature[8]{ 0x89u, 'P', 'N', 'G', '\r', '\n', 0x1Au, '\n' };
+	if (std::memcmp(signature, pngSignature, 8u) == 0)
+	{
+		unsigned char header[16]; // chunk length, "IHDR", width, height
+		if ((!file.read(reinterpret_cast<char*>(header), 16)) || (std::memcmp(header + 4u, "IHDR", 4u) != 0))
+			return false;
+		size = { readBigEndian(header + 8u, 4u), readBigEndian(header + 12u, 4u) };
+		return (size.x > 0u) && (size.y > 0u);
+	}
+
+	if ((signature[0] != 0xFFu) || (signature[1] != 0xD8u))
+		return false;
+	file.seekg(2);
+	unsigned char marker;
+	std::vector<unsigned char> segment;
+	while (readJpegSegment(file, marker, segment))
+	{
+		// start of frame (c0 to cf except c4, c8 and cc which are other tables)
+		if ((marker >= 0xC0u) && (marker <= 0xCFu) && (marker != 0xC4u) && (marker != 0xC8u) && (marker != 0xCCu) && (segment.size() >= 5u))
+		{
+			size = { readBigEndian(segment.data() + 3u, 2u), readBigEndian(segment.data() + 1u, 2u) };
+			return (size.x > 0u) && (size.y > 0u);
+		}
+	}
+	return false;
+}
+
+// the thumbnail is described by the second image file directory of the exif (tiff) data
+bool loadThumbnailFromExif(sf::Image& image, const unsigned char* tiff, const std::size_t size)
+{
+	if (size < 8u)
+		return false;
+	const bool isLittleEndian{ (tiff[0u] == 'I') && (tiff[1u] == 'I') };
+	if ((!isLittleEndian) && ((tiff[0u] != 'M') || (tiff[1u] != 'M')))
+		return false;
+	auto read = [tiff, isLittleEndian](const std::size_t offset, const unsigned int numberOfBytes)
+	{
+		sf::Uint32 value{ 0u };
+		for (unsigned int i{ 0u }; i < numberOfBytes; ++i)
+			value |= static_cast<sf::Uint32>(tiff[offset + i]) << ((isLittleEndian ? i : numberOfBytes - 1u - i) * 8u);
+		return value;
+	};
+
+	const std::size_t firstDirectory{ read(4u, 4u) };
+	if (firstDirectory + 2u > size)
+		return false;
+	const std::size_t nextDirectoryOffset{ firstDirectory + 2u + read(firstDirectory, 2u) * 12u };
+	if (nextDirectoryOffset + 4u > size)
+		return false;
+	const std::size_t secondDirectory{ read(nextDirectoryOffset, 4u) };
+	if ((secondDirectory == 0u) || (secondDirectory + 2u > size))
+		return false;
+	const std::size_t numberOfEntries{ read(secondDirectory, 2u) };
+	std::size_t thumbnailOffset{ 0u };
+	std::size_t thumbnailLength{ 0u };
+	for (std::size_t i{ 0u }; i < numberOfEntries; ++i)
+	{
+		const std::size_t entry{ secondDirectory + 2u + i * 12u };
+		if (entry + 12u > size)
+			return false;
+		const sf::Uint32 tag{ read(entry, 2u) };
+		const sf::Uint32 value{ (read(entry + 2u, 2u) == 3u) ? read(entry + 8u, 2u) : read(entry + 8u, 4u) }; // short or long
+		if (tag == 0x0201u)
+			thumbnailOffset = value;
+		else if (tag == 0x0202u)
+			thumbnailLength = value;
+	}
+	if ((thumbnailOffset == 0u) || (thumbnailLength == 0u) || (thumbnailOffset + thumbnailLength > size))
+		return false;
+	return image.loadFromMemory(tiff + thumbnailOffset, thumbnailLength);
+}
+
+// cameras (and many editors) embed a small thumbnail in a jpeg's exif segment
+bool loadExifThumbnail(sf::Image& image, const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	unsigned char signature[2];
+	if ((!file.read(reinterpret_cast<char*>(signature), 2)) || (signature[0] != 0xFFu) || (signature[1] != 0xD8u))
+		return false;
+	unsigned char marker;
+	std::vector<unsigned char> segment;
+	while (readJpegSegment(file, marker, segment))
+	{
+		if ((marker == 0xE1u) && (segment.size() > 6u) && (std::memcmp(segment.data(), "Exif\0\0", 6u) == 0))
+			return loadThumbnailFromExif(image, segment.data() + 6u, segment.size() - 6u);
+	}
+	return false;
+}
+
+// decodes the full image (through the decoded image cache if enabled), storing a thumbnail for the next progressive load if requested
+bool decodeFullImage(sf::Image& image, const std::string& filename, const bool isCacheEnabled, const std::string& directory, const unsigned int maximumSize, const bool storeThumbnail)
+{
+	if (isCacheEnabled ? !loadImageUsingDecodedImageCache(image, filename, directory, maximumSize) : !image.loadFromFile(filename))
+		return false;
+	if (storeThumbnail)
+		saveThumbnail(image, filename, directory);
+	return true;
+}
+
+// the placeholder is scaled up to the full size (on the GPU) so that texture rectangles stay valid when the full image is swapped in
+bool createPlaceholderTexture(sf::Texture& texture, const sf::Image& placeholder, const sf::Vector2u size)
+{
+	sf::Texture placeholderTexture;
+	sf::RenderTexture renderTexture;
+	if ((!placeholderTexture.loadFromImage(placeholder)) || (!renderTexture.create(size.x, size.y)))
+		return false;
+	placeholderTexture.setSmooth(true);
+	sf::Sprite sprite(placeholderTexture);
+	sprite.setScale(static_cast<float>(size.x) / placeholder.getSize().x, static_cast<float>(size.y) / placeholder.getSize().y);
+	renderTexture.clear(sf::Color::Transparent);
+	renderTexture.draw(sprite, sf::RenderStates(sf::BlendNone));
+	renderTexture.display();
+	if (!texture.create(size.x, size.y))
+		return false;
+	texture.update(renderTexture.getTexture());
+	return true;
+}
+
+
+
+
+// memory accounting
+
+std::size_t estimateTextureGpuMemory(const sf::Vector2u size)
+{
+	return static_cast<std::size_t>(size.x) * size.y * 4u;
+}
+
+std::size_t estimateTextureGpuMemory(const sf::Texture& texture)
+{
+	return estimateTextureGpuMemory(texture.getSize());
+}
+
+// as counted by the memory report once loaded
+std::size_t estimateTextureMemory(const std::string& name, const sf::Vector2u size)
+{
+	return sizeof(sf::Texture) + name.capacity() + estimateTextureGpuMemory(size);
+}
+
+// size of the texture that loading the image creates (read from the header where possible so that it is known before decoding)
+bool getImageTextureSize(const std::string& filename, const unsigned int maximumSize, sf::Vector2u& size)
+{
+	if (!readImageSize(filename, size))
+	{
+		sf::Image image;
+		if (!image.loadFromFile(filename))
+			return false;
+		size = image.getSize();
+	}
+	size = getDownscaledSize(size, maximumSize);
+	return true;
+}
+
+std::size_t estimateRenderTargetGpuMemory(const sf::VideoMode& videoMode, const sf::ContextSettings& contextSettings)
+{
+	const std::size_t bytesPerPixel{ 4u + (contextSettings.depthBits + contextSettings.stencilBits + 7u) / 8u };
+	return static_cast<std::size_t>(videoMode.width) * videoMode.height * bytesPerPixel * std::max(contextSettings.antialiasingLevel, 1u);
+}
+
+// geometry that the drawable builds and keeps on the CPU
+std::size_t estimateDrawableGeometryMemory(const sf::Drawable& drawable)
+{
+	if (const sf::Text* text = dynamic_cast<const sf::Text*>(&drawable))
+		return text->getString().getSize() * 6u * sizeof(sf::Vertex) * 2u; // fill and outline vertices
+	if (const Splashentation::SdfText* sdfText = dynamic_cast<const Splashentation::SdfText*>(&drawable))
+		return sdfText->getVertexCount() * sizeof(sf::Vertex);
+	if (const sf::Shape* shape = dynamic_cast<const sf::Shape*>(&drawable))
+		return (shape->getPointCount() + 2u) * sizeof(sf::Vertex) + (shape->getPointCount() + 1u) * 2u * sizeof(sf::Vertex); // fill and outline vertices
+	if (const sf::VertexArray* vertexArray = dynamic_cast<const sf::VertexArray*>(&drawable))
+		return vertexArray->getVertexCount() * sizeof(sf::Vertex);
+	return 0u;
+}
+
+const sf::Texture* getDrawableTexture(const sf::Drawable& drawable)
+{
+	if (const sf::Sprite* sprite = dynamic_cast<const sf::Sprite*>(&drawable))
+		return sprite->getTexture();
+	if (const sf::Shape* shape = dynamic_cast<const sf::Shape*>(&drawable))
+		return shape->getTexture();
+	return nullptr;
+}
+
+// hit region of the drawable types that have bounds (vertex arrays are already in global coordinates)
+bool getDrawableRegion(const sf::Drawable& drawable, sf::FloatRect& localBounds, sf::Transform& transform)
+{
+	if (const sf::VertexArray* vertexArray = dynamic_cast<const sf::VertexArray*>(&drawable))
+	{
+		localBounds = vertexArray->getBounds();
+		transform = sf::Transform::Identity;
+		return true;
+	}
+	if (const sf::Sprite* sprite = dynamic_cast<const sf::Sprite*>(&drawable))
+		localBounds = sprite->getLocalBounds();
+	else if (const sf::Text* text = dynamic_cast<const sf::Text*>(&drawable))
+		localBounds = text->getLocalBounds();
+	else if (const Splashentation::SdfText* sdfText = dynamic_cast<const Splashentation::SdfText*>(&drawable))
+		localBounds = sdfText->getLocalBounds();
+	else if (const sf::Shape* shape = dynamic_cast<const sf::Shape*>(&drawable))
+		localBounds = shape->getLocalBounds();
+	else
+		return false;
+	transform = dynamic_cast<const sf::Transformable&>(drawable).getTransform();
+	return true;
+}
+
+Splashentation::MouseButtons getMouseButtonFlag(const sf::Mouse::Button mouseButton)
+{
+	switch (mouseButton)
+	{
+	case sf::Mouse::Left:
+		return Splashentation::MouseButtons::Left;
+	case sf::Mouse::Right:
+		return Splashentation::MouseButtons::Right;
+	case sf::Mouse::Middle:
+		return Splashentation::MouseButtons::Middle;
+	default:
+		return Splashentation::MouseButtons::None;
+	}
+}
+
+bool isOutsideView(const sf::Drawable& drawable, const sf::FloatRect& view)
+{
+	sf::FloatRect localBounds;
+	sf::Transform transform;
+	if (!getDrawableRegion(drawable, localBounds, transform))
+		return false; // unknown extent
+	const sf::FloatRect bounds{ transform.transformRect(localBounds) };
+	return (bounds.left > view.left + view.width) || (bounds.left + bounds.width < view.left) || (bounds.top > view.top + view.height) || (bounds.top + bounds.height < view.top);
+}
+
+// opaque sprites and rectangles (with their default alpha blending) hide everything below them where they cover
+bool coversViewOpaquely(const sf::Drawable& drawable, const sf::FloatRect& view) // requires resource lock
+{
+	sf::FloatRect opaqueBounds;
+	const sf::Transformable* transformable;
+	if (const sf::Sprite* sprite = dynamic_cast<const sf::Sprite*>(&drawable))
+	{
+		if ((sprite->getColor().a != 255u) || (sprite->getTexture() == nullptr) || (opaqueTextures.find(sprite->getTexture()) == opaqueTextures.end()))
+			return false;
+		opaqueBounds = sprite->getLocalBounds();
+		transformable = sprite;
+	}
+	else if (const sf::RectangleShape* rectangle = dynamic_cast<const sf::RectangleShape*>(&drawable))
+	{
+		if ((rectangle->getFillColor().a != 255u) || ((rectangle->getTexture() != nullptr) && (opaqueTextures.find(rectangle->getTexture()) == opaqueTextures.end())))
+			return false;
+		opaqueBounds = { 0.f, 0.f, rectangle->getSize().x, rectangle->getSize().y };
+		transformable = rectangle;
+	}
+	else
+		return false;
+
+	// every corner of the view must be within the drawable (tested in its local coordinates so that rotation is allowed)
+	const sf::Transform& inverseTransform{ transformable->getInverseTransform() };
+	const sf::Vector2f corners[]{ { view.left, view.top }, { view.left + view.width, view.top }, { view.left, view.top + view.height }, { view.left + view.width, view.top + view.height } };
+	for (auto& corner : corners)
+	{
+		const sf::Vector2f point{ inverseTransform.transformPoint(corner) };
+		if ((point.x < opaqueBounds.left) || (point.x > opaqueBounds.left + opaqueBounds.width) || (point.y < opaqueBounds.top) || (point.y > opaqueBounds.top + opaqueBounds.height))
+			return false;
+	}
+	return true;
+}
+
+// removes drawables (sorted by z-index) outside the view and those hidden below the topmost drawable that opaquely covers the view.
+// returns whether the view is covered (so that the target does not need clearing)
+bool cullDrawables(std::vector<const Splashentation::OrderedDrawable*>& drawables, const sf::FloatRect& view) // requires resource lock
+{
+	std::size_t firstVisible{ 0u };
+	bool isCovered{ false };
+	for (std::size_t i{ drawables.size() }; i > 0u; --i)
+	{
+		if (coversViewOpaquely(*drawables[i - 1u]->drawable, view))
+		{
+			firstVisible = i - 1u;
+			isCovered = true;
+			break;
+		}
+	}
+	drawables.erase(std::remove_if(drawables.begin() + firstVisible, drawables.end(), [&view](const Splashentation::OrderedDrawable* drawable) { return isOutsideView(*drawable->drawable, view); }), drawables.end());
+	drawables.erase(drawables.begin(), drawables.begin() + firstVisible);
+	return isCovered;
+}
+
+void sortDrawablesByZIndex(std::vector<const Splashentation::OrderedDrawable*>& drawables)
+{
+	// stable so that drawables with the same z index are drawn in slide order (which hit testing also relies on)
+	std::stable_sort(drawables.begin(), drawables.end(),
+		[](const Splashentation::OrderedDrawable* a, const Splashentation::OrderedDrawable* b) { return a->zIndex < b->zIndex; });
+}
+
+// output windows
+
+// the composed frame is scaled uniformly to fit the output and centred (letterboxed)
+struct CompositePlacement
+{
+	float scale;
+	sf::Vector2f offset;
+};
+
+CompositePlacement getCompositePlacement(const sf::Vector2f& targetSize, const sf::Vector2f& compositeSize)
+{
+	const float scale{ std::min(targetSize.x / compositeSize.x, targetSize.y / compositeSize.y) };
+	return{ scale, { (targetSize.x - compositeSize.x * scale) / 2.f, (targetSize.y - compositeSize.y * scale) / 2.f } };
+}
+
+void presentComposite(sf::RenderWindow& window, const sf::Texture& composite)
+{
+	const sf::Vector2f compositeSize(composite.getSize());
+	const CompositePlacement placement{ getCompositePlacement(window.getView().getSize(), compositeSize) };
+	sf::Sprite sprite(composite);
+	sprite.setScale(placement.scale, placement.scale);
+	sprite.setPosition(placement.offset);
+	window.clear(sf::Color::Black);
+	window.draw(sprite);
+	window.display();
+}
+
+// mouse positions in an output window are converted to the matching pixel of the main window so that controls and interactive drawables behave the same in every window
+void convertOutputMouseEvent(sf::Event& event, const sf::RenderWindow& output, const sf::RenderWindow& window, const sf::Vector2f& compositeSize)
+{
+	auto convert = [&](int& x, int& y)
+	{
+		const CompositePlacement placement{ getCompositePlacement(output.getView().getSize(), compositeSize) };
+		const sf::Vector2f outputCoords{ output.mapPixelToCoords({ x, y }) };
+		const sf::Vector2i windowPixel{ window.mapCoordsToPixel({ (outputCoords.x - placement.offset.x) / placement.scale, (outputCoords.y - placement.offset.y) / placement.scale }) };
+		x = windowPixel.x;
+		y = windowPixel.y;
+	};
+	if (event.type == sf::Event::MouseMoved)
+		convert(event.mouseMove.x, event.mouseMove.y);
+	else if ((event.type == sf::Event::MouseButtonPressed) || (event.type == sf::Event::MouseButtonReleased))
+		convert(event.mouseButton.x, event.mouseButton.y);
+}
+
+std::vector<const sf::Drawable*> getDrawablePointers(const std::vector<const Splashentation::OrderedDrawable*>& orderedDrawables)
+{
+	std::vector<const sf::Drawable*> drawables;
+	drawables.reserve(orderedDrawables.size());
+	for (auto& orderedDrawable : orderedDrawables)
+		drawables.push_back(orderedDrawable->drawable.get());
+	return drawables;
+}
+
+// chooses the render scale for transitions from measured frame times.
+// full resolution is used outside of transitions; the scale reached during the last transition is where the next one starts
+class RenderScaleController
+{
+public:
+	explicit RenderScaleController(const Splashentation::DynamicResolutionSettings& settings)
+		: m_settings(settings)
+		, m_transitionScale(1.f)
+		, m_averageWorkTime(0.f)
+		, m_framesSinceChange(0u)
+	{
+	}
+	float update(const sf::Time workTime, const bool isTransitioning)
+	{
+		const float work{ workTime.asSeconds() };
+		m_averageWorkTime = (m_averageWorkTime == 0.f) ? work : m_averageWorkTime * 0.8f + work * 0.2f;
+		if (!isTransitioning)
+			return 1.f;
+
+		if (++m_framesSinceChange < m_settings.framesBetweenChanges)
+			return m_transitionScale;
+		const float targetFrameTime{ m_settings.targetFrameTime.asSeconds() };
+		if ((m_averageWorkTime > targetFrameTime * m_settings.reduceThreshold) && (m_transitionScale > m_settings.minimumScale))
+		{
+			m_transitionScale = std::max(m_transitionScale * 0.85f, m_settings.minimumScale);
+			m_framesSinceChange = 0u;
+		}
+		else if ((m_averageWorkTime < targetFrameTime * m_settings.increaseThreshold) && (m_transitionScale < 1.f))
+		{
+			m_transitionScale = std::min(m_transitionScale * 1.1f, 1.f);
+			m_framesSinceChange = 0u;
+		}
+		return m_transitionScale;
+	}
+
+private:
+	const Splashentation::DynamicResolutionSettings m_settings;
+	float m_transitionScale;
+	float m_averageWorkTime; // seconds (exponential moving average)
+	unsigned int m_framesSinceChange;
+};
+
+// cpu time used by the calling thread. returns false if it is not available
+bool getThreadCpuTime(sf::Time& cpuTime)
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+	timespec time;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+		return false;
+	cpuTime = sf::microseconds(static_cast<sf::Int64>(time.tv_sec) * 1000000 + static_cast<sf::Int64>(time.tv_nsec) / 1000);
+	return true;
+#else
+	return false;
+#endif // defined(CLOCK_THREAD_CPUTIME_ID)
+}
+
+// keeps the render thread within a cpu budget (proportion of one core), measured over short periods.
+// over budget, frame rate is lowered a step at a time and, at the lowest frame rate, transitions are disabled.
+// these are restored in reverse order when usage is comfortably within budget
+class CpuBudgetGovernor
+{
+public:
+	CpuBudgetGovernor(const float budget, const sf::Time baseFrameTime, const sf::Time cpuTime)
+		: m_budget(budget)
+		, m_baseFrameTime(baseFrameTime)
+		, m_maximumFrameTime(std::max(baseFrameTime, sf::milliseconds(100)))
+		, m_frameTime(baseFrameTime)
+		, m_areTransitionsDisabled(false)
+		, m_usage(0.f)
+		, m_degradations(0u)
+		, m_periodStartTime(getSteadyTimeInMicroseconds())
+		, m_periodStartCpuTime(cpuTime)
+	{
+	}
+	// returns true at the end of each measurement period
+	bool update(const sf::Time cpuTime)
+	{
+		const sf::Int64 currentTime{ getSteadyTimeInMicroseconds() };
+		const sf::Int64 periodLength{ currentTime - m_periodStartTime };
+		if (periodLength < 500000) // microseconds
+			return false;
+		m_usage = static_cast<float>((cpuTime - m_periodStartCpuTime).asMicroseconds()) / periodLength;
+		m_periodStartTime = currentTime;
+		m_periodStartCpuTime = cpuTime;
+
+		if (m_usage > m_budget)
+		{
+			if (m_frameTime < m_maximumFrameTime)
+			{
+				m_frameTime = std::min(m_frameTime * 1.5f, m_maximumFrameTime);
+				++m_degradations;
+			}
+			else if (!m_areTransitionsDisabled)
+			{
+				m_areTransitionsDisabled = true;
+				++m_degradations;
+			}
+		}
+		else if (m_areTransitionsDisabled)
+		{
+			if (m_usage < m_budget * 0.5f)
+				m_areTransitionsDisabled = false;
+		}
+		else if ((m_frameTime > m_baseFrameTime) && (m_usage * 1.5f < m_budget * 0.9f)) // usage is expected to rise with frame rate
+			m_frameTime = std::max(m_frameTime / 1.5f, m_baseFrameTime);
+		return true;
+	}
+	sf::Time getFrameTime() const { return m_frameTime; }
+	bool areTransitionsDisabled() const { return m_areTransitionsDisabled; }
+	bool isDegraded() const { return m_areTransitionsDisabled || (m_frameTime > m_baseFrameTime); }
+	float getUsage() const { return m_usage; }
+	unsigned int getDegradations() const { return m_degradations; }
+
+private:
+	const float m_budget;
+	const sf::Time m_baseFrameTime;
+	const sf::Time m_maximumFrameTime;
+	sf::Time m_frameTime;
+	bool m_areTransitionsDisabled;
+	float m_usage;
+	unsigned int m_degradations;
+	sf::Int64 m_periodStartTime; // microseconds (steady clock)
+	sf::Time m_periodStartCpuTime;
+};
+
+template <class keyT, class valueT>
+std::size_t estimateUnorderedMapMemory(const std::unordered_map<keyT, valueT>& map)
+{
+	return map.size() * (sizeof(std::pair<const keyT, valueT>) + 2u * sizeof(void*)) + map.bucket_count() * sizeof(void*);
+}
+
+template <class slideControlsT>
+std::size_t estimateSlideControlsMemory(const slideControlsT& slideControls)
+{
+	return sizeof(slideControlsT) + estimateUnorderedMapMemory(slideControls.keys) + estimateUnorderedMapMemory(slideControls.mouseButtons) +
+		(slideControls.compiledKeys.capacity() + slideControls.compiledMouseButtons.capacity()) * sizeof(slideControls.compiledKeys[0]);
+}
+
 } // namespace
 
-Splashentation::Splashentation(const sf::VideoMode& videoMode, const std::string& name, const unsigned int style, const sf::ContextSettings& contextSettings)
-	: m_window(nullptr)
-	, m_clock()
-	, m_slides()
-	, m_playThread()
-	, m_playState(PlayState::Ready)
-	, m_moveOnToNextSlide(false)
+struct Splashentation::ReplayEvents
+{
+	std::deque<sf::Event> events;
+};
+
+Splashentation::Splashentation(const sf::VideoMode& videoMode, const std::string& name, const unsigned int style, const sf::ContextSettings& contextSettings)
+	: m_decodedImageCacheSettings{ false, "", 0u }
+	, m_window(nullptr)
+	, m_slides()
+	, m_loadingScheduler(new LoadingScheduler)
+	, m_progressiveTextureLoader(new ProgressiveTextureLoader(resourceMutex, *m_loadingScheduler))
+	, m_replayEvents(new ReplayEvents)
+	, m_playThread()
+	, m_drawablesMutex(new ContentionTrackingMutex)
+	, m_playState(PlayState::Ready)
+	, m_moveOnToNextSlide(false)
+	, m_controlSkip(false)
+	, m_controlQuit(false)
+	, m_currentSlideIndex(0u)
+	, m_slideStartTime(getSteadyTimeInMicroseconds())
+{
+	setupWindow(videoMode, name, style, contextSettings);
+}
+
+Splashentation::~Splashentation()
+{
+	priv_cancelPreparedThread();
+	priv_waitForThreadToFinish();
+	disconnectFromHost();
+}
+
+void Splashentation::clearAllResources()
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	fonts.clear();
+	fontSourceSizes.clear();
+	evictableFonts.clear();
+	sdfFonts.clear();
+	evictableSdfFonts.clear();
+	evictableTextures.clear();
+	m_progressiveTextureLoader->cancelAll();
+	opaqueTextures.clear();
+	textures.clear();
+}
+
+void Splashentation::prepare()
+{
+	if (isPlaying())
+		return;
+
+	std::unique_lock<std::mutex> prepareLock(m_prepareMutex);
+	if (m_isPrepareRequested)
+		return;
+	prepareLock.unlock();
+	priv_waitForThreadToFinish();
+	prepareLock.lock();
+
+	m_controlQuit = false;
+	m_isPlayRequested = false;
+	m_isPrepareRequested = true;
+	m_startupTimesMutex.lock();
+	m_startupTimes = StartupTimes();
+	m_startupTimesMutex.unlock();
+	m_startupRequestTime = getSteadyTimeInMicroseconds();
+	priv_takePlayWindowSettings();
+	priv_startPlayThread();
+}
+
+void Splashentation::play()
+{
+	// a connected application follows the host, which plays the presentation
+	if ((isPlaying()) || (m_isConnectedToHost) || ((m_slides.size() == 0) && (!m_slideSource)))
+		return;
+
+	if (m_isRecording)
+	{
+		TraceRecord record(TraceRecord::Type::Play);
+		priv_recordTrace(record);
+	}
+
+	std::unique_lock<std::mutex> prepareLock(m_prepareMutex);
+	const bool isPrepared{ m_isPrepareRequested };
+	if (!isPrepared)
+	{
+		prepareLock.unlock();
+		priv_waitForThreadToFinish();
+		prepareLock.lock();
+		m_startupTimesMutex.lock();
+		m_startupTimes = StartupTimes();
+		m_startupTimesMutex.unlock();
+		m_startupRequestTime = getSteadyTimeInMicroseconds();
+	}
+
+	m_currentSlideIndex = 0u;
+	m_moveOnToNextSlide = false;
+	m_controlSkip = false;
+	m_controlQuit = false;
+	m_slideState = SlideState::In;
+	m_playState = PlayState::Playing;
+	priv_compileControls(m_globalControls);
+	m_inputLatencyMutex.lock();
+	m_inputLatency = InputLatency();
+	m_inputLatencyMutex.unlock();
+	m_frameTimingsMutex.lock();
+	m_frameTimings = FrameTimings();
+	m_frameTimeHistogram.assign(251u, 0u);
+	m_frameTimingsMutex.unlock();
+	m_drawablesMutex->resetContention();
+	m_playRequestTime = getSteadyTimeInMicroseconds();
+	m_isPrepareRequested = false;
+	m_isPlayRequested = true;
+	if (!isPrepared)
+		priv_takePlayWindowSettings();
+
+	// a window that is handed off is created here so that it belongs to the calling thread (the render thread only activates its context)
+	if (m_isWindowHandoffEnabled)
+	{
+		const sf::Int64 windowCreationStartTime{ getSteadyTimeInMicroseconds() };
+		m_window.reset(new sf::RenderWindow(m_playWindowSettings.videoMode, m_playWindowSettings.name, m_playWindowSettings.style, m_playWindowSettings.contextSettings));
+		m_window->setActive(false);
+		std::lock_guard<std::mutex> lockGuard(m_startupTimesMutex);
+		m_startupTimes.windowCreation = sf::microseconds(getSteadyTimeInMicroseconds() - windowCreationStartTime);
+	}
+	if (isPrepared)
+		m_prepareCondition.notify_one();
+	else
+		priv_startPlayThread();
+}
+
+void Splashentation::next()
+{
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::Next);
+		priv_recordTrace(record);
+	}
+	priv_next();
+}
+
+void Splashentation::skip()
+{
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::Skip);
+		priv_recordTrace(record);
+	}
+	m_controlSkip = true;
+}
+
+void Splashentation::quit()
+{
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::Quit);
+		priv_recordTrace(record);
+	}
+	m_controlQuit = true;
+	cancelLoading();
+
+	// also cancels a prepared render thread that has not been played yet
+	std::lock_guard<std::mutex> lockGuard(m_prepareMutex);
+	m_prepareCondition.notify_one();
+}
+
+Splashentation::StartupTimes Splashentation::getStartupTimes() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_startupTimesMutex);
+	return m_startupTimes;
+}
+
+void Splashentation::t_play()
+{
+	const sf::Int64 threadStartTime{ getSteadyTimeInMicroseconds() };
+	// streamed slides are released when playback ends (after any background preparation that uses them has finished)
+	struct SlideStreamerStopper
+	{
+		SlideStreamer* slideStreamer;
+		~SlideStreamerStopper() { if (slideStreamer != nullptr) slideStreamer->stop(); }
+	} slideStreamerStopper{ m_slideStreamer.get() };
+	const RenderThreadSettings renderThreadSettings{ getRenderThreadSettings() };
+	priv_applyRenderThreadSettings(renderThreadSettings);
+	std::unique_ptr<sf::RenderTexture> renderTexture(new sf::RenderTexture);
+	const WindowSettings& windowSettings{ m_playWindowSettings };
+	const std::vector<OutputWindowSettings>& outputWindowSettings{ m_playOutputWindowSettings };
+	renderTexture->create(windowSettings.videoMode.width, windowSettings.videoMode.height);
+	const sf::Int64 renderTextureCreatedTime{ getSteadyTimeInMicroseconds() };
+	// output windows show the frame composed (once) into the composite texture
+	std::unique_ptr<sf::RenderTexture> compositeTexture;
+	if (!outputWindowSettings.empty())
+	{
+		compositeTexture.reset(new sf::RenderTexture);
+		compositeTexture->create(windowSettings.videoMode.width, windowSettings.videoMode.height);
+		compositeTexture->setSmooth(true);
+	}
+
+	// when prepared, wait for play() before creating the windows (SFML shows a window as soon as it is created so they could not be kept hidden)
+	{
+		std::unique_lock<std::mutex> prepareLock(m_prepareMutex);
+		if (!m_isPlayRequested)
+		{
+			m_prepareCondition.wait(prepareLock, [this] { return m_isPlayRequested || m_controlQuit; });
+			if (!m_isPlayRequested)
+			{
+				m_isPrepareRequested = false;
+				return;
+			}
+		}
+	}
+	const sf::Int64 waitEndTime{ getSteadyTimeInMicroseconds() };
+	if (m_window)
+		m_window->setActive(true); // created by play() for handoff
+	else
+		m_window.reset(new sf::RenderWindow(windowSettings.videoMode, windowSettings.name, windowSettings.style, windowSettings.contextSettings));
+	const sf::Int64 windowCreatedTime{ getSteadyTimeInMicroseconds() };
+	// output windows are synchronised to their displays (so that they do not tear) and are presented last, so their vertical sync paces the frame
+	for (auto& outputSettings : outputWindowSettings)
+	{
+		m_outputWindows.emplace_back(new sf::RenderWindow(outputSettings.videoMode, outputSettings.name, outputSettings.style, windowSettings.contextSettings));
+		m_outputWindows.back()->setPosition(outputSettings.position);
+		m_outputWindows.back()->setVerticalSyncEnabled(true);
+		m_outputWindows.back()->setFramerateLimit(0u);
+	}
+	const DynamicResolutionSettings dynamicResolution{ getDynamicResolution() };
+	const bool isFrameRateLimitedHere{ dynamicResolution.isEnabled || (renderThreadSettings.cpuBudget > 0.f) };
+	const sf::Time targetFrameTime{ dynamicResolution.isEnabled ? dynamicResolution.targetFrameTime : sf::seconds(1.f / 60.f) };
+	m_window->setFramerateLimit((isFrameRateLimitedHere || !m_outputWindows.empty()) ? 0u : 60u); // dynamic resolution and cpu budget limit frame rate here so that they can measure work time
+	if (m_isHeadless)
+	{
+		m_window->setVisible(false);
+		for (auto& output : m_outputWindows)
+			output->setVisible(false);
+	}
+	{
+		std::lock_guard<std::mutex> lockGuard(m_startupTimesMutex);
+		m_startupTimes.threadStart = sf::microseconds(threadStartTime - m_startupRequestTime);
+		m_startupTimes.renderTextureCreation = sf::microseconds(renderTextureCreatedTime - threadStartTime);
+		m_startupTimes.waitForPlay = sf::microseconds(waitEndTime - renderTextureCreatedTime);
+		m_startupTimes.windowCreation += sf::microseconds(windowCreatedTime - waitEndTime);
+	}
+	bool isFirstFrame{ true };
+	sf::Int64 previousDisplayTime{ 0 }; // microseconds (steady clock)
+
+	// large slides have their geometry prepared on worker threads. the next frame is prepared in the background while the current one is displayed
+	// and is used if no drawables have changed in the meantime. (prepared frame must outlive the preparer, which finishes any background work)
+	struct PreparedFrame
+	{
+		bool isValid;
+		sf::Uint64 drawablesVersion;
+		const CompactSlide* currentSlide;
+		const CompactSlide* previousSlide;
+		FramePreparer::Batches current;
+		FramePreparer::Batches previous;
+	} preparedFrame{ false, 0u, nullptr, nullptr, FramePreparer::Batches(), FramePreparer::Batches() };
+	sf::Uint64 lastFrameDrawablesVersion{ 0u }; // while drawables change every frame (such as with loading progress), a frame prepared in advance would be discarded so is not prepared
+	const std::size_t parallelPreparationThreshold{ m_parallelPreparationThreshold };
+
+	// dynamic resolution (standard compositor only)
+	RenderScaleController renderScaleController(dynamicResolution);
+	std::unique_ptr<sf::RenderTexture> previousRenderTexture;
+	sf::Clock frameClock;
+	float renderScale{ 1.f };
+	m_renderScale = renderScale;
+	if (dynamicResolution.isEnabled)
+		renderTexture->setSmooth(true);
+	const sf::FloatRect viewBounds{ 0.f, 0.f, static_cast<float>(renderTexture->getSize().x), static_cast<float>(renderTexture->getSize().y) };
+
+	// software compositor
+	struct CachedSlideImage
+	{
+		const CompactSlide* slide;
+		sf::Uint64 drawablesVersion;
+		std::vector<const OrderedDrawable*> drawables; // the layers held in the image (any above them are drawn directly)
+		sf::Image image;
+	} cachedCurrentSlideImage{ nullptr, 0u, {}, sf::Image() }, cachedPreviousSlideImage{ nullptr, 0u, {}, sf::Image() };
+	struct Composition
+	{
+		bool isValid;
+		const CompactSlide* currentSlide;
+		const CompactSlide* previousSlide;
+		sf::Uint8 alpha;
+	} lastComposition{ false, nullptr, nullptr, 0u };
+	std::unique_ptr<SoftwareCompositor> softwareCompositor;
+	sf::Texture presentTexture;
+	if (m_compositor == Compositor::Software)
+	{
+		softwareCompositor.reset(new SoftwareCompositor);
+		softwareCompositor->setSize(renderTexture->getSize());
+		presentTexture.create(renderTexture->getSize().x, renderTexture->getSize().y);
+	}
+	std::unique_ptr<FramePreparer> framePreparer;
+	if (parallelPreparationThreshold > 0u)
+	{
+		const unsigned int numberOfCores{ std::thread::hardware_concurrency() };
+		framePreparer.reset(new FramePreparer((numberOfCores > 1u) ? numberOfCores - 1u : 0u, priv_getHelperThreadSetup()));
+	}
+	getMemoryReport(); // include render targets in peak memory
+
+	// cpu budget (uses thread cpu time where available; otherwise, time spent working on frames)
+	sf::Time totalWorkTime{ sf::Time::Zero };
+	auto getRenderThreadCpuTime = [&]()
+	{
+		sf::Time cpuTime;
+		return getThreadCpuTime(cpuTime) ? cpuTime : totalWorkTime;
+	};
+	std::unique_ptr<CpuBudgetGovernor> cpuBudgetGovernor;
+	if (renderThreadSettings.cpuBudget > 0.f)
+		cpuBudgetGovernor.reset(new CpuBudgetGovernor(renderThreadSettings.cpuBudget, targetFrameTime, getRenderThreadCpuTime()));
+	bool areTransitionsDisabled{ false };
+	{
+		std::lock_guard<std::mutex> lockGuard(m_renderThreadMutex);
+		m_renderThreadReport.frameRateLimit = 1.f / targetFrameTime.asSeconds();
+	}
+
+	// slides come from the added slides or, with a slide source, from the slides loaded around the current one
+	const std::size_t numberOfSlides{ m_slideStreamer ? m_slideStreamer->getNumberOfSlides() : m_slides.size() };
+	auto getSlide = [this](const std::size_t index) -> const CompactSlide*
+	{
+		if (m_slideStreamer)
+			return m_slideStreamer->getSlide(index);
+		return (index < m_slides.size()) ? &m_slides[index] : nullptr;
+	};
+	std::size_t currentSlideIndex{ 0u };
+	bool hasPreviousSlide{ false }; // previous slide is the one before the current slide
+	bool isComplete{ (numberOfSlides == 0u) };
+	float displayedLoadingProgressRatio{ -1.f };
+	sf::Clock inputLatencyClock;
+	sf::Time inputLatencyStart{ sf::Time::Zero };
+	bool isInputLatencyPending{ false };
+
+	// interactive drawables of the current slide are hit tested using a spatial index of their regions (keyed by position in the slide)
+	RegionIndex regionIndex;
+	const CompactSlide* indexedSlide{ nullptr };
+	sf::Uint64 indexedInteractionsVersion{ 0u };
+	std::unordered_map<std::string, std::size_t> regionKeys;
+	std::string hoveredDrawable;
+	sf::Vector2f mousePosition;
+	bool isMouseInWindow{ false };
+	const sf::RenderWindow* mouseWindow{ nullptr }; // window (main or output) the mouse last moved in
+	auto indexRegion = [&](const std::string& id, const std::size_t key) // requires m_drawablesMutex
+	{
+		const OrderedDrawable& drawable{ m_drawables[id] };
+		sf::FloatRect localBounds;
+		sf::Transform transform;
+		if ((drawable.drawable != nullptr) && (getDrawableRegion(*drawable.drawable, localBounds, transform)))
+			regionIndex.set(key, localBounds, transform, drawable.zIndex);
+		else
+			regionIndex.remove(key);
+	};
+	m_slideStartTime = getSteadyTimeInMicroseconds();
+	while (!isComplete)
+	{
+		frameClock.restart();
+		if (framePreparer)
+			framePreparer->waitForBackground();
+		if (m_slideStreamer)
+			m_slideStreamer->setCurrentSlide(currentSlideIndex); // slides that have been left are released (no longer used by background preparation)
+		const CompactSlide* const currentSlide{ getSlide(currentSlideIndex) }; // null while a streamed slide is still loading
+		const CompactSlide* const previousSlide{ hasPreviousSlide ? getSlide(currentSlideIndex - 1u) : nullptr };
+		const bool showCurrentSlide{ currentSlide != nullptr };
+		const bool showPreviousSlide{ (priv_getSlideState() == SlideState::In) && (previousSlide != nullptr) && (!areTransitionsDisabled) };
+		const CompactSlide* const currentSlidePointer{ currentSlide };
+		const CompactSlide* const previousSlidePointer{ showPreviousSlide ? previousSlide : nullptr };
+
+		// prepare a "list" of drawables, sorted by z-index
+		std::vector<const OrderedDrawable*> currentSortedDrawables;
+		std::vector<const OrderedDrawable*> previousSortedDrawables;
+		
+		const LoadingProgress loadingProgress{ getLoadingProgress() };
+
+		m_drawablesMutex->lock();
+		if ((loadingProgress.ratio != displayedLoadingProgressRatio) && (!m_loadingProgressBindings.empty()))
+		{
+			displayedLoadingProgressRatio = loadingProgress.ratio;
+			priv_applyLoadingProgressBindings(displayedLoadingProgressRatio);
+		}
+		if (showCurrentSlide)
+			priv_gatherDrawables(*currentSlide, currentSortedDrawables);
+		if (showPreviousSlide)
+			priv_gatherDrawables(*previousSlide, previousSortedDrawables);
+		m_drawablesMutex->unlock();
+
+		sortDrawablesByZIndex(currentSortedDrawables);
+		sortDrawablesByZIndex(previousSortedDrawables);
+
+		m_drawablesMutex->lock();
+		resourceMutex.lock();
+
+		// drawables outside the view, or hidden below an opaque drawable covering it, are not drawn (and a covered target is not cleared)
+		const bool isCurrentSlideCovered{ cullDrawables(currentSortedDrawables, viewBounds) };
+		const bool isPreviousSlideCovered{ cullDrawables(previousSortedDrawables, viewBounds) };
+
+		const bool isPreparedInParallel{ (framePreparer) && ((currentSortedDrawables.size() + previousSortedDrawables.size()) >= parallelPreparationThreshold) };
+		const bool areDrawablesChanging{ m_drawablesVersion != lastFrameDrawablesVersion };
+		lastFrameDrawablesVersion = m_drawablesVersion;
+		if ((isPreparedInParallel) && ((!preparedFrame.isValid) || (preparedFrame.drawablesVersion != m_drawablesVersion) || (preparedFrame.currentSlide != currentSlidePointer) || (preparedFrame.previousSlide != previousSlidePointer)))
+		{
+			framePreparer->prepare(getDrawablePointers(currentSortedDrawables), preparedFrame.current);
+			framePreparer->prepare(getDrawablePointers(previousSortedDrawables), preparedFrame.previous);
+		}
+
+		// draws a slide's drawables (using the prepared geometry if it was prepared in parallel)
+		auto drawSlide = [&](sf::RenderTarget& target, const std::vector<const OrderedDrawable*>& sortedDrawables, const FramePreparer::Batches& batches)
+		{
+			if (isPreparedInParallel)
+				FramePreparer::draw(target, batches);
+			else
+			{
+				for (auto& drawable : sortedDrawables)
+					target.draw(*(drawable->drawable));
+			}
+		};
+
+		float alpha{ 1.f };
+		if (showCurrentSlide)
+		{
+			alpha = ((priv_getSlideState() == SlideState::In) && (!areTransitionsDisabled)) ? getSlideTime().asSeconds() / currentSlide->transition.asSeconds() : 1.f;
+			if (alpha < 0)
+				alpha = 0.f;
+			else if (alpha > 1)
+				alpha = 1.f;
+		}
+
+		// with output windows, the frame is composed off-screen once and then presented to every window
+		sf::RenderTarget& compositeTarget{ compositeTexture ? static_cast<sf::RenderTarget&>(*compositeTexture) : static_cast<sf::RenderTarget&>(*m_window) };
+
+		if (softwareCompositor)
+		{
+			// slides are rendered (and read back) only when they change. they are then composed on the CPU and presented with a single texture update
+			// while drawables are changing (e.g. progress bindings while loading), only the layers below them are read back; the changing layers and any above them are drawn directly over the composition
+			// returns the index of the first drawable to draw directly
+			auto updateCachedSlideImage = [&](CachedSlideImage& cachedSlideImage, const CompactSlide* slide, const std::vector<const OrderedDrawable*>& sortedDrawables, const FramePreparer::Batches& batches, const bool isCovered, const bool canDrawDirectly) -> std::size_t
+			{
+				std::size_t directIndex{ sortedDrawables.size() };
+				const bool isLayoutUnchanged{ (cachedSlideImage.slide == slide) && (m_drawablesLayoutVersion <= cachedSlideImage.drawablesVersion) };
+				if ((canDrawDirectly) && (areDrawablesChanging) && (isLayoutUnchanged))
+				{
+					for (std::size_t i{ 0u }; i < sortedDrawables.size(); ++i)
+					{
+						const std::unordered_map<const OrderedDrawable*, sf::Uint64>::const_iterator changeVersion{ m_drawableChangeVersions.find(sortedDrawables[i]) };
+						if ((changeVersion != m_drawableChangeVersions.end()) && (changeVersion->second > cachedSlideImage.drawablesVersion))
+						{
+							directIndex = i;
+							break;
+						}
+					}
+				}
+				const std::size_t cachedIndex{ cachedSlideImage.drawables.size() };
+				// a partial image is kept only while drawables are still changing (the whole slide is read back once they settle)
+				const bool isCacheCurrent{ (cachedIndex < sortedDrawables.size()) ? (directIndex < sortedDrawables.size()) : (cachedSlideImage.drawablesVersion == m_drawablesVersion) };
+				if ((isLayoutUnchanged) && (isCacheCurrent) && (cachedIndex <= directIndex) && (std::equal(cachedSlideImage.drawables.begin(), cachedSlideImage.drawables.end(), sortedDrawables.begin())))
+					return cachedIndex; // none of the cached layers changed
+				if (directIndex == sortedDrawables.size())
+				{
+					if (!isCovered)
+						renderTexture->clear(slide->color);
+					drawSlide(*renderTexture, sortedDrawables, batches);
+				}
+				else
+				{
+					renderTexture->clear(slide->color); // the drawable covering the slide may be one of those drawn directly
+					for (std::size_t i{ 0u }; i < directIndex; ++i)
+						renderTexture->draw(*(sortedDrawables[i]->drawable));
+				}
+				renderTexture->display();
+				cachedSlideImage.image = renderTexture->getTexture().copyToImage();
+				cachedSlideImage.slide = slide;
+				cachedSlideImage.drawablesVersion = m_drawablesVersion;
+				cachedSlideImage.drawables.assign(sortedDrawables.begin(), sortedDrawables.begin() + directIndex);
+				lastComposition.isValid = false;
+				return directIndex;
+			};
+			const sf::Uint8 alphaByte{ static_cast<sf::Uint8>(255.f * alpha) };
+			if ((showPreviousSlide) && (cachedPreviousSlideImage.slide != previousSlidePointer) && (cachedCurrentSlideImage.slide == previousSlidePointer))
+				std::swap(cachedPreviousSlideImage, cachedCurrentSlideImage); // the slide that was current is now the previous slide
+			// layers can only be drawn directly over a fully opaque current slide (not during a transition)
+			std::size_t currentDirectIndex{ currentSortedDrawables.size() };
+			if (showCurrentSlide)
+				currentDirectIndex = updateCachedSlideImage(cachedCurrentSlideImage, currentSlidePointer, currentSortedDrawables, preparedFrame.current, isCurrentSlideCovered, (!showPreviousSlide) && (alphaByte == 255u));
+			if (showPreviousSlide)
+				updateCachedSlideImage(cachedPreviousSlideImage, previousSlidePointer, previousSortedDrawables, preparedFrame.previous, isPreviousSlideCovered, false);
+
+			if ((!lastComposition.isValid) || (lastComposition.currentSlide != currentSlidePointer) || (lastComposition.previousSlide != previousSlidePointer) || (lastComposition.alpha != alphaByte))
+			{
+				if (showPreviousSlide)
+					softwareCompositor->copy(cachedPreviousSlideImage.image.getPixelsPtr());
+				else
+					softwareCompositor->clear(sf::Color::Black);
+				if (showCurrentSlide)
+					softwareCompositor->blend(cachedCurrentSlideImage.image.getPixelsPtr(), alpha);
+				presentTexture.update(softwareCompositor->getPixels());
+				lastComposition = { true, currentSlidePointer, previousSlidePointer, alphaByte };
+			}
+			compositeTarget.draw(sf::Sprite(presentTexture));
+			for (std::size_t i{ currentDirectIndex }; i < currentSortedDrawables.size(); ++i)
+				compositeTarget.draw(*(currentSortedDrawables[i]->drawable));
+		}
+		else
+		{
+			// at reduced scale, slides are drawn into the top-left part of the off-screen targets (using the viewport) and stretched over the window
+			const bool isScaled{ renderScale < 1.f };
+			const sf::Vector2u fullSize{ renderTexture->getSize() };
+			sf::View scaledView(renderTexture->getDefaultView());
+			scaledView.setViewport({ 0.f, 0.f, renderScale, renderScale });
+			const sf::IntRect scaledRect(0, 0, static_cast<int>(fullSize.x * renderScale), static_cast<int>(fullSize.y * renderScale));
+			auto drawScaledTarget = [&](const sf::RenderTexture& target, const sf::Color& color)
+			{
+				sf::Sprite scaledSprite(target.getTexture(), scaledRect);
+				scaledSprite.setScale({ static_cast<float>(fullSize.x) / scaledRect.width, static_cast<float>(fullSize.y) / scaledRect.height });
+				scaledSprite.setColor(color);
+				compositeTarget.draw(scaledSprite);
+			};
+			renderTexture->setView(isScaled ? scaledView : renderTexture->getDefaultView());
+
+			// prepare overlay for current slide
+			if (!showCurrentSlide)
+				renderTexture->clear(sf::Color::Black);
+			else
+			{
+				if (!isCurrentSlideCovered)
+					renderTexture->clear(currentSlide->color);
+				drawSlide(*renderTexture, currentSortedDrawables, preparedFrame.current);
+			}
+			renderTexture->display();
+
+			// draw slides
+
+			if (!showPreviousSlide)
+				compositeTarget.clear(sf::Color::Black);
+			else if (!isScaled)
+			{
+				if (!isPreviousSlideCovered)
+					compositeTarget.clear(previousSlide->color);
+				drawSlide(compositeTarget, previousSortedDrawables, preparedFrame.previous);
+			}
+			else
+			{
+				if (!previousRenderTexture)
+				{
+					previousRenderTexture.reset(new sf::RenderTexture);
+					previousRenderTexture->create(fullSize.x, fullSize.y);
+					previousRenderTexture->setSmooth(true);
+				}
+				previousRenderTexture->setView(scaledView);
+				if (!isPreviousSlideCovered)
+					previousRenderTexture->clear(previousSlide->color);
+				drawSlide(*previousRenderTexture, previousSortedDrawables, preparedFrame.previous);
+				previousRenderTexture->display();
+				drawScaledTarget(*previousRenderTexture, sf::Color::White);
+			}
+			const sf::Color overlayColor(255, 255, 255, showCurrentSlide ? static_cast<sf::Uint8>(255.f * alpha) : 255);
+			if (isScaled)
+				drawScaledTarget(*renderTexture, overlayColor);
+			else
+			{
+				sf::Sprite renderSprite(renderTexture->getTexture());
+				renderSprite.setColor(overlayColor);
+				compositeTarget.draw(renderSprite);
+			}
+		}
+
+		resourceMutex.unlock();
+		m_drawablesMutex->unlock();
+
+		// prepare the next frame while this one is displayed
+		if ((isPreparedInParallel) && (!areDrawablesChanging))
+		{
+			preparedFrame.isValid = false;
+			framePreparer->runInBackground([this, &preparedFrame, &framePreparer, &viewBounds, currentSlidePointer, previousSlidePointer]()
+			{
+				std::vector<const OrderedDrawable*> current;
+				std::vector<const OrderedDrawable*> previous;
+				std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+				if (currentSlidePointer != nullptr)
+					priv_gatherDrawables(*currentSlidePointer, current);
+				if (previousSlidePointer != nullptr)
+					priv_gatherDrawables(*previousSlidePointer, previous);
+				sortDrawablesByZIndex(current);
+				sortDrawablesByZIndex(previous);
+				resourceMutex.lock();
+				cullDrawables(current, viewBounds);
+				cullDrawables(previous, viewBounds);
+				resourceMutex.unlock();
+				framePreparer->prepare(getDrawablePointers(current), preparedFrame.current);
+				framePreparer->prepare(getDrawablePointers(previous), preparedFrame.previous);
+				preparedFrame.drawablesVersion = m_drawablesVersion;
+				preparedFrame.currentSlide = currentSlidePointer;
+				preparedFrame.previousSlide = previousSlidePointer;
+				preparedFrame.isValid = true;
+			});
+		}
+
+		if (compositeTexture)
+		{
+			compositeTexture->display();
+			m_window->clear(sf::Color::Black);
+			m_window->draw(sf::Sprite(compositeTexture->getTexture()));
+		}
+		m_window->display();
+		const sf::Time workTime{ frameClock.getElapsedTime() }; // excludes waiting for the outputs' vertical sync
+		if (compositeTexture)
+		{
+			for (auto& output : m_outputWindows)
+				presentComposite(*output, compositeTexture->getTexture());
+			m_window->setActive(true);
+		}
+		totalWorkTime += workTime;
+		if (dynamicResolution.isEnabled && !softwareCompositor)
+		{
+			renderScale = renderScaleController.update(workTime, showPreviousSlide || (priv_getSlideState() == SlideState::In));
+			m_renderScale = renderScale;
+		}
+		sf::Time frameTime{ targetFrameTime };
+		if (cpuBudgetGovernor)
+		{
+			if (cpuBudgetGovernor->update(getRenderThreadCpuTime()))
+			{
+				areTransitionsDisabled = cpuBudgetGovernor->areTransitionsDisabled();
+				std::lock_guard<std::mutex> lockGuard(m_renderThreadMutex);
+				m_renderThreadReport.cpuUsage = cpuBudgetGovernor->getUsage();
+				m_renderThreadReport.frameRateLimit = 1.f / cpuBudgetGovernor->getFrameTime().asSeconds();
+				m_renderThreadReport.areTransitionsDisabled = areTransitionsDisabled;
+				m_renderThreadReport.isDegraded = cpuBudgetGovernor->isDegraded();
+				m_renderThreadReport.degradations = cpuBudgetGovernor->getDegradations();
+			}
+			frameTime = cpuBudgetGovernor->getFrameTime();
+		}
+		const sf::Time elapsedFrameTime{ frameClock.getElapsedTime() };
+		if (isFrameRateLimitedHere && (elapsedFrameTime < frameTime))
+			sf::sleep(frameTime - elapsedFrameTime);
+		const sf::Int64 displayTime{ getSteadyTimeInMicroseconds() };
+		if (!isFirstFrame)
+			priv_recordFrameTime(sf::microseconds(displayTime - previousDisplayTime));
+		previousDisplayTime = displayTime;
+		if (isFirstFrame)
+		{
+			isFirstFrame = false;
+			std::lock_guard<std::mutex> lockGuard(m_startupTimesMutex);
+			m_startupTimes.firstFrame = sf::microseconds(getSteadyTimeInMicroseconds() - m_playRequestTime);
+			m_startupTimes.total = sf::microseconds(getSteadyTimeInMicroseconds() - m_startupRequestTime);
+		}
+
+		// input latency is measured from when the input event is received until the frame showing its result is displayed
+		if (isInputLatencyPending)
+		{
+			priv_recordInputLatency(inputLatencyClock.getElapsedTime() - inputLatencyStart);
+			isInputLatencyPending = false;
+		}
+
+		// interactive drawables (the index is rebuilt for a new slide; otherwise, only the regions of changed drawables are updated)
+		bool isHoverChanged{ false };
+		{
+			std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+			if ((currentSlidePointer != indexedSlide) || (m_drawableInteractionsVersion != indexedInteractionsVersion))
+			{
+				indexedSlide = currentSlidePointer;
+				indexedInteractionsVersion = m_drawableInteractionsVersion;
+				regionIndex.clear();
+				regionKeys.clear();
+				if (indexedSlide != nullptr)
+				{
+					for (std::size_t i{ 0u }; i < indexedSlide->ids.size(); ++i)
+					{
+						if (m_drawableInteractions.find(indexedSlide->ids[i]) != m_drawableInteractions.end())
+							regionKeys[indexedSlide->ids[i]] = i; // a drawable added more than once responds where it is drawn last
+					}
+					for (auto& regionKey : regionKeys)
+						indexRegion(regionKey.first, regionKey.second);
+				}
+				isHoverChanged = true;
+			}
+			else
+			{
+				for (auto& id : m_movedInteractiveDrawables)
+				{
+					const std::unordered_map<std::string, std::size_t>::const_iterator regionKey{ regionKeys.find(id) };
+					if (regionKey != regionKeys.end())
+						indexRegion(regionKey->first, regionKey->second);
+				}
+				isHoverChanged = !m_movedInteractiveDrawables.empty();
+			}
+			m_movedInteractiveDrawables.clear();
+		}
+
+		// handle events (window events, then output window events, are followed by any input events from a replay)
+		std::size_t polledOutputWindow{ 0u };
+		const sf::RenderWindow* eventWindow{ nullptr };
+		auto pollEvent = [this, &polledOutputWindow, &eventWindow, &compositeTexture](sf::Event& event)
+		{
+			eventWindow = m_window.get(); // also for input events from a replay
+			bool isPolled{ m_window->pollEvent(event) };
+			for (; (!isPolled) && (polledOutputWindow < m_outputWindows.size()); ++polledOutputWindow)
+			{
+				sf::RenderWindow& output{ *m_outputWindows[polledOutputWindow] };
+				isPolled = output.pollEvent(event);
+				if (isPolled)
+				{
+					eventWindow = &output;
+					convertOutputMouseEvent(event, output, *m_window, sf::Vector2f(compositeTexture->getSize()));
+					break;
+				}
+			}
+			if (!isPolled)
+				return priv_popReplayEvent(event);
+			if (m_isRecording)
+				priv_recordEvent(event);
+			return true;
+		};
+		sf::Event event;
+		while (pollEvent(event))
+		{
+			const sf::Time eventTime{ inputLatencyClock.getElapsedTime() };
+			if (event.type == sf::Event::Closed)
+			{
+				priv_endPlay(PlayState::Quit);
+				return;
+			}
+			else if (event.type == sf::Event::MouseMoved)
+			{
+				mousePosition = m_window->mapPixelToCoords({ event.mouseMove.x, event.mouseMove.y });
+				isMouseInWindow = true;
+				mouseWindow = eventWindow;
+				isHoverChanged = true;
+			}
+			else if ((event.type == sf::Event::MouseLeft) && (eventWindow == mouseWindow))
+			{
+				// leaving a window that the mouse has already moved on from does not end the hover
+				isMouseInWindow = false;
+				mouseWindow = nullptr;
+				isHoverChanged = true;
+			}
+			else if ((event.type == sf::Event::MouseButtonPressed) || (event.type == sf::Event::KeyPressed))
+			{
+				const bool isMouseButton{ event.type == sf::Event::MouseButtonPressed };
+
+				// the topmost interactive drawable under the mouse takes the click from slide and global controls
+				bool isDrawableClicked{ false };
+				ControlAction drawableControlAction{ ControlAction::None };
+				std::size_t regionKey;
+				if ((isMouseButton) && (regionIndex.find(m_window->mapPixelToCoords({ event.mouseButton.x, event.mouseButton.y }), regionKey)))
+				{
+					std::function<void()> clickCallback;
+					m_drawablesMutex->lock();
+					const std::unordered_map<std::string, DrawableInteraction>::const_iterator interaction{ m_drawableInteractions.find(indexedSlide->ids[regionKey]) };
+					if ((interaction != m_drawableInteractions.end()) && ((interaction->second.clickMouseButtons & getMouseButtonFlag(event.mouseButton.button)) != 0))
+					{
+						isDrawableClicked = true;
+						drawableControlAction = interaction->second.clickAction;
+						clickCallback = interaction->second.clickCallback;
+					}
+					m_drawablesMutex->unlock();
+					if (clickCallback)
+						clickCallback();
+				}
+
+				const ControlAction slideControlAction{ ((!showCurrentSlide) || (isDrawableClicked)) ? ControlAction::None : isMouseButton ? priv_getCompiledMouseButtonControlAction(*currentSlide->controls, event.mouseButton.button) : priv_getCompiledKeyControlAction(*currentSlide->controls, event.key.code) };
+				const ControlAction globalControlAction{ (isDrawableClicked) ? ControlAction::None : isMouseButton ? priv_getCompiledMouseButtonControlAction(m_globalControls, event.mouseButton.button) : priv_getCompiledKeyControlAction(m_globalControls, event.key.code) };
+				bool foundControl{ false };
+				if (!priv_processControlAction(drawableControlAction, foundControl) || !priv_processControlAction(slideControlAction, foundControl) || !priv_processControlAction(globalControlAction, foundControl))
+				{
+					priv_recordInputLatency(inputLatencyClock.getElapsedTime() - eventTime);
+					return;
+				}
+				if (foundControl && !isInputLatencyPending)
+				{
+					isInputLatencyPending = true;
+					inputLatencyStart = eventTime;
+				}
+			}
+		}
+
+		// hover (resolved once per frame from the latest mouse position, also when regions have moved under it)
+		if (isHoverChanged)
+		{
+			std::string newHoveredDrawable;
+			std::size_t regionKey;
+			if ((isMouseInWindow) && (regionIndex.find(mousePosition, regionKey)))
+				newHoveredDrawable = indexedSlide->ids[regionKey];
+			if (newHoveredDrawable != hoveredDrawable)
+			{
+				std::function<void(bool)> leaveCallback;
+				std::function<void(bool)> enterCallback;
+				m_drawablesMutex->lock();
+				m_hoveredDrawable = newHoveredDrawable;
+				const std::unordered_map<std::string, DrawableInteraction>::const_iterator leftInteraction{ m_drawableInteractions.find(hoveredDrawable) };
+				if (leftInteraction != m_drawableInteractions.end())
+					leaveCallback = leftInteraction->second.hoverCallback;
+				const std::unordered_map<std::string, DrawableInteraction>::const_iterator enteredInteraction{ m_drawableInteractions.find(newHoveredDrawable) };
+				if (enteredInteraction != m_drawableInteractions.end())
+					enterCallback = enteredInteraction->second.hoverCallback;
+				m_drawablesMutex->unlock();
+				hoveredDrawable = newHoveredDrawable;
+				if (leaveCallback)
+					leaveCallback(false);
+				if (enterCallback)
+					enterCallback(true);
+			}
+		}
+
+		// update
+		if (showCurrentSlide && !m_moveOnToNextSlide)
+		{
+			const sf::Time slideTime{ getSlideTime() };
+			const SlideState currentSlideState{ priv_getSlideState() };
+			if (currentSlideState == SlideState::In)
+			{
+				if ((currentSlide->transition == sf::Time::Zero) || (slideTime >= currentSlide->transition))
+					priv_setSlideState(SlideState::Show);
+			}
+			else if (currentSlideState == SlideState::Show)
+			{
+				if ((currentSlide->duration > sf::Time::Zero) && (slideTime >= (currentSlide->transition + currentSlide->duration)))
+					priv_next();
+				else if ((currentSlide->duration == sf::Time::Zero) && (m_isNextOnLoadingCompleteEnabled) && (loadingProgress.isComplete))
+					priv_next();
+			}
+		}
+
+		// progressive textures: decoded rows are uploaded a band at a time and complete images are swapped in while a slide is shown (not during a transition)
+		if (m_progressiveTextureLoader->update(progressiveUploadBytesPerFrame, priv_getSlideState() == SlideState::Show))
+		{
+			std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+			m_drawablesLayoutVersion = ++m_drawablesVersion;
+		}
+
+		// remote: records from the application are applied as they are when replayed and the state is published for the application to follow
+		if (m_isHosting)
+		{
+			TraceRecord record;
+			while (m_remoteChannel->receive(record))
+				priv_replayRecord(record);
+			m_remoteChannel->setHostState(m_playState, m_currentSlideIndex, getSlideTime());
+		}
+
+		// external controls
+		if (m_controlSkip)
+		{
+			priv_endPlay(PlayState::Finished);
+			return;
+		}
+		if (m_controlQuit)
+		{
+			priv_endPlay(PlayState::Quit);
+			return;
+		}
+
+		// progression (waits for a streamed slide that is still loading)
+		const bool isNextSlideReady{ (currentSlideIndex + 1u >= numberOfSlides) || (getSlide(currentSlideIndex + 1u) != nullptr) };
+		if (isNextSlideReady && m_moveOnToNextSlide.exchange(false))
+		{
+			m_slideStartTime = getSteadyTimeInMicroseconds();
+			hasPreviousSlide = true;
+			if (++currentSlideIndex == numberOfSlides)
+				isComplete = true;
+			else
+			{
+				m_currentSlideIndex = static_cast<unsigned int>(currentSlideIndex);
+				if (m_slideStreamer)
+				{
+					// streamed slides can reuse the memory of released ones so cached frames must not be matched by slide alone
+					std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+					m_drawablesLayoutVersion = ++m_drawablesVersion;
+				}
+				getMemoryReport(); // update peak memory
+			}
+		}
+		else if (!showCurrentSlide)
+			m_slideStartTime = getSteadyTimeInMicroseconds(); // slide time starts once the slide has loaded
+	}
+	priv_endPlay(PlayState::Finished);
+	return;
+}
+
+void Splashentation::t_exchangeWithHost()
+{
+	bool hasSentLoadingProgress{ false };
+	LoadingProgress sentLoadingProgress;
+	sf::Uint32 hostFrame{ 0u };
+	sf::Int64 hostFrameTime{ getSteadyTimeInMicroseconds() };
+	while ((m_isConnectedToHost) && (!m_isHostGone))
+	{
+		// loading progress (sent when it changes)
+		const LoadingProgress loadingProgress{ m_loadingScheduler->getProgress() };
+		if ((!hasSentLoadingProgress) || (loadingProgress.ratio != sentLoadingProgress.ratio) || (loadingProgress.isComplete != sentLoadingProgress.isComplete))
+		{
+			TraceRecord record(TraceRecord::Type::LoadingProgress);
+			record.value = loadingProgress.ratio;
+			record.integer = loadingProgress.isComplete ? 1 : 0;
+			priv_recordTrace(record);
+			sentLoadingProgress = loadingProgress;
+			hasSentLoadingProgress = true;
+		}
+
+		// host state
+		const RemoteChannel::HostState hostState{ m_remoteChannel->getHostState() };
+		const sf::Int64 now{ getSteadyTimeInMicroseconds() };
+		if (hostState.frame != hostFrame)
+		{
+			hostFrame = hostState.frame;
+			hostFrameTime = now;
+		}
+		m_currentSlideIndex = hostState.slideIndex;
+		m_slideStartTime = now - hostState.slideTime.asMicroseconds();
+		if ((hostState.playState == PlayState::Playing) && (now - hostFrameTime > remoteHostTimeout.asMicroseconds()))
+		{
+			m_playState = PlayState::Quit;
+			break;
+		}
+		m_playState = hostState.playState;
+		if ((hostState.playState == PlayState::Finished) || (hostState.playState == PlayState::Quit))
+			break;
+
+		sf::sleep(remoteExchangeInterval);
+	}
+	m_isHostGone = true;
+}
+
+void Splashentation::setWindowHandoff(const bool enableWindowHandoff)
+{
+	if (isPlaying())
+		return;
+
+	m_isWindowHandoffEnabled = enableWindowHandoff;
+}
+
+bool Splashentation::getWindowHandoff() const
+{
+	return m_isWindowHandoffEnabled;
+}
+
+std::unique_ptr<sf::RenderWindow> Splashentation::takeWindow()
+{
+	priv_cancelPreparedThread();
+	priv_waitForThreadToFinish();
+	if ((m_window == nullptr) || (!m_window->isOpen()) || (m_playState != PlayState::Finished))
+	{
+		m_window.reset();
+		return nullptr;
+	}
+
+	return std::move(m_window);
+}
+
+void Splashentation::addOutputWindow(const sf::VideoMode& videoMode, const sf::Vector2i position, const std::string& name, const unsigned int style)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
+	m_outputWindowSettings.push_back({ videoMode, position, name, style });
+}
+
+void Splashentation::clearOutputWindows()
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
+	m_outputWindowSettings.clear();
+}
+
+std::size_t Splashentation::getNumberOfOutputWindows() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
+	return m_outputWindowSettings.size();
+}
+
+void Splashentation::setupWindow(const sf::VideoMode& videoMode, const std::string& name, const unsigned int style, const sf::ContextSettings& contextSettings)
+{
+	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
+	m_windowSettings = { videoMode, name, style, contextSettings };
+}
+
+sf::Vector2u Splashentation::getWindowSize() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
+	return{ m_windowSettings.videoMode.width, m_windowSettings.videoMode.height };
+}
+
+void Splashentation::addFont(const std::string& name, sf::Font& font)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<ContentionTrackingMutex> drawablesLockGuard(*m_drawablesMutex);
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (!priv_fitWithinMemoryBudget(sizeof(sf::Font) + name.capacity()))
+		return;
+	fonts[name] = font;
+	fontSourceSizes[name] = 0u;
+}
+
+bool Splashentation::loadFont(const std::string& name, const std::string& filename)
+{
+	std::lock_guard<ContentionTrackingMutex> drawablesLockGuard(*m_drawablesMutex);
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isPlaying())
+		return false;
+
+	// font data is kept in memory so the file size is known before loading
+	sf::Uint64 sourceSize;
+	sf::Int64 sourceModificationTime;
+	const std::size_t fontSourceSize{ getSourceFileInformation(filename, sourceSize, sourceModificationTime) ? static_cast<std::size_t>(sourceSize) : 0u };
+	if (!priv_fitWithinMemoryBudget(sizeof(sf::Font) + name.capacity() + fontSourceSize))
+		return false;
+
+	// loaded separately so that a failed load keeps the previous font (that text points to)
+	sf::Font font;
+	if (!font.loadFromFile(filename))
+		return false;
+	fonts[name] = font;
+	fontSourceSizes[name] = fontSourceSize;
+	return true;
+}
+
+void Splashentation::removeFont(const std::string& name)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	fonts.erase(name);
+	fontSourceSizes.erase(name);
+	evictableFonts.erase(name);
+}
+
+void Splashentation::setFontEvictable(const std::string& name, const bool isEvictable)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isEvictable)
+		evictableFonts.insert(name);
+	else
+		evictableFonts.erase(name);
+}
+
+sf::Font* Splashentation::getFont(const std::string& name) const
+{
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	return (isPlaying() ? nullptr : &fonts[name]);
+}
+
+bool Splashentation::loadSdfFont(const std::string& name, const std::string& filename)
+{
+	std::unique_lock<std::mutex> cacheSettingsLock(m_decodedImageCacheSettingsMutex);
+	const DecodedImageCacheSettings cacheSettings{ m_decodedImageCacheSettings };
+	cacheSettingsLock.unlock();
+	const std::string cacheFilename{ cacheSettings.isEnabled ? getSdfFontCacheFilename(cacheSettings.directory, filename) : "" };
+
+	std::lock_guard<ContentionTrackingMutex> drawablesLockGuard(*m_drawablesMutex);
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isPlaying())
+		return false;
+
+	// a failed (or refused) load leaves a previous font unchanged
+	const bool isNew{ sdfFonts.find(name) == sdfFonts.end() };
+	if (sdfFonts[name].loadFromFile(filename, cacheFilename, [this](const std::size_t bytes) { return priv_fitWithinMemoryBudget(bytes); }))
+		return true;
+	if (isNew)
+		sdfFonts.erase(name);
+	return false;
+}
+
+void Splashentation::removeSdfFont(const std::string& name)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	sdfFonts.erase(name);
+	evictableSdfFonts.erase(name);
+}
+
+void Splashentation::setSdfFontEvictable(const std::string& name, const bool isEvictable)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isEvictable)
+		evictableSdfFonts.insert(name);
+	else
+		evictableSdfFonts.erase(name);
+}
+
+Splashentation::SdfFont* Splashentation::getSdfFont(const std::string& name) const
+{
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isPlaying())
+		return nullptr;
+	const std::unordered_map<std::string, SdfFont>::iterator sdfFont{ sdfFonts.find(name) };
+	return (sdfFont != sdfFonts.end()) ? &sdfFont->second : nullptr;
+}
+
+void Splashentation::addTexture(const std::string& name, sf::Texture& texture)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<ContentionTrackingMutex> drawablesLockGuard(*m_drawablesMutex);
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (!priv_fitWithinMemoryBudget(estimateTextureMemory(name, texture.getSize())))
+		return;
+	sf::Texture& existingTexture{ textures[name] };
+	m_progressiveTextureLoader->cancel(existingTexture);
+	opaqueTextures.erase(&existingTexture); // not known
+	existingTexture = texture;
+}
+
+bool Splashentation::loadTexture(const std::string& name, const std::string& filename)
+{
+	std::unique_lock<std::mutex> cacheSettingsLock(m_decodedImageCacheSettingsMutex);
+	const DecodedImageCacheSettings cacheSettings{ m_decodedImageCacheSettings };
+	cacheSettingsLock.unlock();
+
+	std::lock_guard<ContentionTrackingMutex> drawablesLockGuard(*m_drawablesMutex);
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isPlaying())
+		return false;
+
+	// refused before decoding so that the budget is never exceeded
+	sf::Vector2u size;
+	if ((m_memoryBudget != 0u) && ((!getImageTextureSize(filename, cacheSettings.isEnabled ? cacheSettings.maximumSize : 0u, size)) || (!priv_fitWithinMemoryBudget(estimateTextureMemory(name, size)))))
+		return false;
+
+	// loaded separately and swapped in so that a failed load keeps the previous texture (that sprites point to)
+	sf::Texture texture;
+	bool isOpaque{ false };
+	const bool isLoaded{ cacheSettings.isEnabled ?
+		loadTextureUsingDecodedImageCache(texture, filename, cacheSettings.directory, cacheSettings.maximumSize, isOpaque) :
+		loadTextureFromFile(texture, filename, isOpaque) };
+	if (!isLoaded)
+		return false;
+	sf::Texture& existingTexture{ textures[name] };
+	m_progressiveTextureLoader->cancel(existingTexture);
+	texture.setSmooth(existingTexture.isSmooth());
+	texture.setRepeated(existingTexture.isRepeated());
+	existingTexture.swap(texture);
+	if (isOpaque)
+		opaqueTextures.insert(&existingTexture);
+	else
+		opaqueTextures.erase(&existingTexture);
+	return true;
+}
+
+bool Splashentation::loadTextureProgressively(const std::string& name, const std::string& filename)
+{
+	std::unique_lock<std::mutex> cacheSettingsLock(m_decodedImageCacheSettingsMutex);
+	const DecodedImageCacheSettings cacheSettings{ m_decodedImageCacheSettings };
+	cacheSettingsLock.unlock();
+	if (isPlaying())
+		return false;
+
+	// placeholder is a thumbnail stored by an earlier load or the one embedded in the file
+	sf::Image placeholder;
+	sf::Vector2u size;
+	const bool isThumbnailStored{ cacheSettings.isEnabled && loadThumbnail(placeholder, filename, cacheSettings.directory) };
+	const bool hasPlaceholder{ readImageSize(filename, size) && (isThumbnailStored || loadExifThumbnail(placeholder, filename)) };
+	const bool storeThumbnail{ cacheSettings.isEnabled && !isThumbnailStored };
+	const std::function<bool(sf::Image&)> decode{ [filename, cacheSettings, storeThumbnail](sf::Image& image)
+	{
+		return decodeFullImage(image, filename, cacheSettings.isEnabled, cacheSettings.directory, cacheSettings.maximumSize, storeThumbnail);
+	} };
+
+	// without a placeholder there is nothing to show early so the image is loaded now (storing a thumbnail makes the next load progressive)
+	sf::Image image;
+	if ((!hasPlaceholder) && (!decode(image)))
+		return false;
+
+	std::lock_guard<ContentionTrackingMutex> drawablesLockGuard(*m_drawablesMutex);
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isPlaying())
+		return false;
+
+	// the full image decoded in the background (and the texture it is uploaded to) is counted from now
+	const sf::Vector2u textureSize{ hasPlaceholder ? getDownscaledSize(size, cacheSettings.isEnabled ? cacheSettings.maximumSize : 0u) : image.getSize() };
+	if (!priv_fitWithinMemoryBudget(estimateTextureMemory(name, textureSize) + (hasPlaceholder ? ProgressiveTextureLoader::estimateMemoryUsage(textureSize).getTotal() : 0u)))
+		return false;
+
+	// created separately and swapped in so that a failed load keeps the previous texture (that sprites point to)
+	sf::Texture texture;
+	if (hasPlaceholder ? !createPlaceholderTexture(texture, placeholder, textureSize) : !texture.loadFromImage(image))
+		return false;
+	sf::Texture& existingTexture{ textures[name] };
+	m_progressiveTextureLoader->cancel(existingTexture);
+	opaqueTextures.erase(&existingTexture); // not known (the full image has not been decoded yet)
+	texture.setSmooth(existingTexture.isSmooth());
+	texture.setRepeated(existingTexture.isRepeated());
+	existingTexture.swap(texture);
+	if (hasPlaceholder)
+		m_progressiveTextureLoader->add(existingTexture, decode);
+	return true;
+}
+
+void Splashentation::removeTexture(const std::string& name)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	const std::unordered_map<std::string, sf::Texture>::iterator texture{ textures.find(name) };
+	if (texture == textures.end())
+		return;
+	m_progressiveTextureLoader->cancel(texture->second);
+	opaqueTextures.erase(&texture->second);
+	textures.erase(texture);
+	evictableTextures.erase(name);
+}
+
+void Splashentation::setTextureEvictable(const std::string& name, const bool isEvictable)
+{
+	if (isPlaying())
+		return;
+
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	if (isEvictable)
+		evictableTextures.insert(name);
+	else
+		evictableTextures.erase(name);
+}
+
+sf::Texture* Splashentation::getTexture(const std::string& name) const
+{
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	return (isPlaying() ? nullptr : &textures[name]);
+}
+
+void Splashentation::enableDecodedImageCache(const std::string& directory, const unsigned int maximumSize)
+{
+	// directory must be supplied
+	assert(directory != "");
+
+	std::lock_guard<std::mutex> lockGuard(m_decodedImageCacheSettingsMutex);
+	m_decodedImageCacheSettings = { true, directory, maximumSize };
+}
+
+void Splashentation::disableDecodedImageCache()
+{
+	std::lock_guard<std::mutex> lockGuard(m_decodedImageCacheSettingsMutex);
+	m_decodedImageCacheSettings.isEnabled = false;
+}
+
+bool Splashentation::isDecodedImageCacheEnabled() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_decodedImageCacheSettingsMutex);
+	return m_decodedImageCacheSettings.isEnabled;
+}
+
+Splashentation::MemoryReport Splashentation::getMemoryReport() const
+{
+	std::lock_guard<ContentionTrackingMutex> drawablesLockGuard(*m_drawablesMutex);
+	std::lock_guard<std::mutex> lockGuard(resourceMutex);
+	return priv_calculateMemoryReport();
+}
+
+void Splashentation::setMemoryBudget(const std::size_t bytes, const MemoryBudgetPolicy policy)
+{
+	m_memoryBudget = bytes;
+	m_memoryBudgetPolicy = policy;
+}
+
+std::size_t Splashentation::getMemoryBudget() const
+{
+	return m_memoryBudget;
+}
+
+void Splashentation::addSlide(Slide&& slide)
+{
+	if (isPlaying())
+		return;
+
+	m_slides.emplace_back(priv_compactSlide(std::move(slide), m_internedSlideControls));
+}
+
+void Splashentation::addSlide(const Slide& slide)
+{
+	Slide copy;
+	copy.color = slide.color;
+	copy.duration = slide.duration;
+	copy.transition = slide.transition;
+	copy.ids = slide.ids;
+	copy.keys = slide.keys;
+	copy.mouseButtons = slide.mouseButtons;
+	addSlide(std::move(copy));
+}
+
+void Splashentation::clearSlides()
+{
+	if (isPlaying())
+		return;
+
+	m_slides.clear();
+	m_internedSlideControls.clear();
+}
+
+void Splashentation::setSlideSource(std::unique_ptr<SlideSource> slideSource, const std::size_t numberOfSlidesAhead)
+{
+	if (isPlaying())
+		return;
+
+	// a prepared render thread is waiting to play the current slides
+	{
+		std::lock_guard<std::mutex> lockGuard(m_prepareMutex);
+		if (m_isPrepareRequested)
+			return;
+	}
+	priv_waitForThreadToFinish();
+	m_slideStreamer.reset();
+	m_slideSource = std::move(slideSource);
+	m_numberOfSlidesAhead = std::max<std::size_t>(numberOfSlidesAhead, 1u); // the next slide must be loaded before the presentation can move on to it
+}
+
+void Splashentation::addGlobalControlAction(const ControlAction controlAction, const sf::Keyboard::Key key)
+{
+	if (isPlaying())
+		return;
+
+	if (m_globalControls.keys.count(key) == 0)
+		m_globalControls.keys[key] = controlAction;
+}
+
+void Splashentation::removeGlobalControlAction(const sf::Keyboard::Key key)
+{
+	if (isPlaying())
+		return;
+
+	m_globalControls.keys.erase(key);
+}
+
+Splashentation::ControlAction Splashentation::getGlobalControlAction(const sf::Keyboard::Key key) const
+{
+	if (isPlaying())
+		return ControlAction::None;
+
+	const std::unordered_map<sf::Keyboard::Key, ControlAction>::const_iterator result{ m_globalControls.keys.find(key) };
+	return (result == m_globalControls.keys.end() ? ControlAction::None : result->second);
+}
+
+void Splashentation::setGlobalMouseButtons(const ControlAction controlAction, const MouseButtons mouseButtons)
+{
+	if (isPlaying())
+		return;
+
+	m_globalControls.mouseButtons[controlAction] = mouseButtons;
+}
+
+Splashentation::MouseButtons Splashentation::getGlobalMouseButtons(const ControlAction controlAction) const
+{
+	if (isPlaying())
+		return MouseButtons::None;
+
+	const std::unordered_map<ControlAction, MouseButtons>::const_iterator result{ m_globalControls.mouseButtons.find(controlAction) };
+	return (result == m_globalControls.mouseButtons.end() ? MouseButtons::None : result->second);
+}
+
+void Splashentation::addSlideControlAction(const unsigned int slideIndex, const ControlAction controlAction, const sf::Keyboard::Key key)
 {
-	setupWindow(videoMode, name, style, contextSettings);
+	if (isPlaying())
+		return;
+
+	SlideControls controls{ *m_slides[slideIndex].controls };
+	if (controls.keys.count(key) == 0)
+		controls.keys[key] = controlAction;
+	m_slides[slideIndex].controls = priv_internSlideControls(controls, m_internedSlideControls);
 }
 
-Splashentation::~Splashentation()
+void Splashentation::removeSlideControlAction(const unsigned int slideIndex, const sf::Keyboard::Key key)
 {
-	priv_waitForThreadToFinish();
+	if (isPlaying())
+		return;
+
+	SlideControls controls{ *m_slides[slideIndex].controls };
+	controls.keys.erase(key);
+	m_slides[slideIndex].controls = priv_internSlideControls(controls, m_internedSlideControls);
 }
 
-void Splashentation::clearAllResources()
+Splashentation::ControlAction Splashentation::getSlideControlAction(const unsigned int slideIndex, const sf::Keyboard::Key key) const
 {
 	if (isPlaying())
-		return;
+		return ControlAction::None;
 
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	fonts.clear();
-	textures.clear();
+	const std::unordered_map<sf::Keyboard::Key, ControlAction>& keys{ m_slides[slideIndex].controls->keys };
+	const std::unordered_map<sf::Keyboard::Key, ControlAction>::const_iterator result{ keys.find(key) };
+	return (result == keys.end() ? ControlAction::None : result->second);
 }
 
-void Splashentation::play()
+void Splashentation::setSlideMouseButtons(const unsigned int slideIndex, const ControlAction controlAction, const MouseButtons mouseButtons)
 {
-	if ((isPlaying()) || (m_slides.size() == 0))
+	if (isPlaying())
 		return;
 
-	m_currentSlideIndex = 0u;
-	m_moveOnToNextSlide = false;
-	m_slideState = SlideState::In;
-	m_playState = PlayState::Playing;
-	m_playThread = std::thread(&Splashentation::t_play, this);
+	SlideControls controls{ *m_slides[slideIndex].controls };
+	controls.mouseButtons[controlAction] = mouseButtons;
+	m_slides[slideIndex].controls = priv_internSlideControls(controls, m_internedSlideControls);
 }
 
-void Splashentation::next()
+Splashentation::MouseButtons Splashentation::getSlideMouseButtons(const unsigned int slideIndex, const ControlAction controlAction) const
 {
-	std::lock_guard<std::mutex> lockGuard(m_controlsMutex);
-	m_moveOnToNextSlide = true;
-	priv_setSlideState(SlideState::In);
+	if (isPlaying())
+		return MouseButtons::None;
+
+	const std::unordered_map<ControlAction, MouseButtons>& mouseButtons{ m_slides[slideIndex].controls->mouseButtons };
+	const std::unordered_map<ControlAction, MouseButtons>::const_iterator result{ mouseButtons.find(controlAction) };
+	return (result == mouseButtons.end() ? MouseButtons::None : result->second);
 }
 
-void Splashentation::skip()
+void Splashentation::setDrawableClickAction(const std::string& id, const ControlAction controlAction, const MouseButtons mouseButtons, const std::function<void()>& callback)
 {
-	std::lock_guard<std::mutex> lockGuard(m_controlsMutex);
-	m_controlSkip = true;
+	// ID must be supplied
+	assert(id != "");
+
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	DrawableInteraction& interaction{ priv_getDrawableInteraction(id) };
+	interaction.clickAction = controlAction;
+	interaction.clickMouseButtons = mouseButtons;
+	interaction.clickCallback = callback;
 }
 
-void Splashentation::quit()
+void Splashentation::setDrawableHoverCallback(const std::string& id, const std::function<void(bool)>& callback)
 {
-	std::lock_guard<std::mutex> lockGuard(m_controlsMutex);
-	m_controlQuit = true;
+	// ID must be supplied
+	assert(id != "");
+
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	priv_getDrawableInteraction(id).hoverCallback = callback;
 }
 
-void Splashentation::t_play()
+void Splashentation::removeDrawableInteraction(const std::string& id)
 {
-	std::vector<Slide>::iterator currentSlide{ m_slides.begin() };
-	std::vector<Slide>::iterator previousSlide{ m_slides.end() };
-	std::unique_ptr<sf::RenderTexture> renderTexture(new sf::RenderTexture);
-	m_windowSettingsMutex.lock();
-	m_window.reset(new sf::RenderWindow(m_windowSettings.videoMode, m_windowSettings.name, m_windowSettings.style, m_windowSettings.contextSettings));
-	renderTexture->create(m_windowSettings.videoMode.width, m_windowSettings.videoMode.height);
-	m_windowSettingsMutex.unlock();
-	m_window->setFramerateLimit(60);
-	bool isComplete{ false };
-	m_clockMutex.lock();
-	m_clock.restart();
-	m_clockMutex.unlock();
-	while (!isComplete)
-	{
-		const bool showCurrentSlide{ currentSlide != m_slides.end() };
-		const bool showPreviousSlide{ (m_slideState == SlideState::In) && (previousSlide != m_slides.end()) };
-
-		// prepare a "list" of drawables, sorted by z-index
-		std::vector<OrderedDrawable*> currentSortedDrawables;
-		std::vector<OrderedDrawable*> previousSortedDrawables;
-		
-		m_drawablesMutex.lock();
-		if (showCurrentSlide)
-		{
-			currentSortedDrawables.reserve(currentSlide->ids.size());
-			for (auto& id : currentSlide->ids)
-			{
-				if (m_drawables[id].drawable != nullptr)
-					currentSortedDrawables.push_back(&m_drawables[id]);
-			}
-		}
-		if (showPreviousSlide)
-		{
-			previousSortedDrawables.reserve(previousSlide->ids.size());
-			for (auto& id : previousSlide->ids)
-			{
-				if (m_drawables[id].drawable != nullptr)
-					previousSortedDrawables.push_back(&m_drawables[id]);
-			}
-		}
-		m_drawablesMutex.unlock();
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	if (m_drawableInteractions.erase(id) != 0u)
+		++m_drawableInteractionsVersion;
+}
 
-		std::sort(currentSortedDrawables.begin(), currentSortedDrawables.end(),
-			[](const OrderedDrawable* a, const OrderedDrawable* b) { return a->zIndex < b->zIndex; });
-		std::sort(previousSortedDrawables.begin(), previousSortedDrawables.end(),
-			[](const OrderedDrawable* a, const OrderedDrawable* b) { return a->zIndex < b->zIndex; });
+std::string Splashentation::getHoveredDrawable() const
+{
+	if (!isPlaying())
+		return "";
 
-		m_drawablesMutex.lock();
-		resourceMutex.lock();
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	return m_hoveredDrawable;
+}
 
-		// prepare overlay for current slide
-		if (!showCurrentSlide)
-			renderTexture->clear(sf::Color::Black);
-		else
-		{
-			renderTexture->clear(currentSlide->color);
-			for (auto& drawable : currentSortedDrawables)
-				renderTexture->draw(*(drawable->drawable));
-		}
-		renderTexture->display();
+bool Splashentation::isPlaying() const
+{
+	return (getPlayState() == PlayState::Playing);
+}
 
-		// draw slides
+Splashentation::PlayState Splashentation::getPlayState() const
+{
+	return m_playState;
+}
 
-		if (!showPreviousSlide)
-			m_window->clear(sf::Color::Black);
-		else
-		{
-			m_window->clear(previousSlide->color);
-			for (auto& drawable : previousSortedDrawables)
-				m_window->draw(*(drawable->drawable));
-		}
-		//if (showCurrentSlide)
-		{
-			sf::Sprite renderSprite(renderTexture->getTexture());
-			if (showCurrentSlide)
-			{
-				float alpha{ (priv_getSlideState() == SlideState::In) ? getSlideTime().asSeconds() / currentSlide->transition.asSeconds() : 1.f };
-				if (alpha < 0)
-					alpha = 0.f;
-				else if (alpha > 1)
-					alpha = 1.f;
-				renderSprite.setColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(255.f * alpha)));
-			}
-			m_window->draw(renderSprite);
-		}
+sf::Time Splashentation::getSlideTime() const
+{
+	return sf::microseconds(getSteadyTimeInMicroseconds() - m_slideStartTime);
+}
 
-		resourceMutex.unlock();
-		m_drawablesMutex.unlock();
-		m_window->display();
+unsigned int Splashentation::getCurrentSlideIndex() const
+{
+	return m_currentSlideIndex;
+}
 
-		// handle events
-		sf::Event event;
-		while (m_window->pollEvent(event))
-		{
-			if (event.type == sf::Event::Closed)
-			{
-				m_window->close();
-				std::lock_guard<std::mutex> lockGuard(m_playStateMutex);
-				m_playState = PlayState::Quit;
-				return;
-			}
-			else if (event.type == sf::Event::MouseButtonPressed)
-			{
-				bool foundMouseButton{ false };
-				for (auto& buttons : currentSlide->mouseButtons)
-				{
-					if (!priv_processMouseButton(buttons, event.mouseButton.button, foundMouseButton))
-						return;
-				}
-				for (auto& buttons : m_globalMouseButtons)
-				{
-					if (!priv_processMouseButton(buttons, event.mouseButton.button, foundMouseButton))
-						return;
-				}
-				if (!foundMouseButton)
-				{
-					// button not found
-				}
-			}
-			else if (event.type == sf::Event::KeyPressed)
-			{
-				bool foundKey{ false };
-				for (auto& key : currentSlide->keys)
-				{
-					if (!priv_processKey(key, event.key.code, foundKey))
-						return;
-				}
-				for (auto& key : m_globalKeys)
-				{
-					if (!priv_processKey(key, event.key.code, foundKey))
-						return;
-				}
-				if (!foundKey)
-				{
-					// key not found
-				}
-			}
-		}
+Splashentation::InputLatency Splashentation::getInputLatency() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_inputLatencyMutex);
+	return m_inputLatency;
+}
 
-		std::lock_guard<std::mutex> lockGuardClock(m_clockMutex);
 
-		// update
-		if (showCurrentSlide && !m_moveOnToNextSlide)
-		{
-			const SlideState currentSlideState{ priv_getSlideState() };
-			if (currentSlideState == SlideState::In)
-			{
-				if ((currentSlide->transition == sf::Time::Zero) || (m_clock.getElapsedTime() >= currentSlide->transition))
-					priv_setSlideState(SlideState::Show);
-			}
-			else if (currentSlideState == SlideState::Show)
-			{
-				if ((currentSlide->duration > sf::Time::Zero) && (m_clock.getElapsedTime() >= (currentSlide->transition + currentSlide->duration)))
-					next();
-			}
-		}
 
-		std::lock_guard<std::mutex> lockGuardControls(m_controlsMutex);
+// loading
 
-		// external controls
-		if (m_controlSkip)
-		{
-			m_window->close();
-			std::lock_guard<std::mutex> lockGuardPlayState(m_playStateMutex);
-			m_playState = PlayState::Finished;
-			return;
-		}
-		if (m_controlQuit)
-		{
-			m_window->close();
-			std::lock_guard<std::mutex> lockGuardPlayState(m_playStateMutex);
-			m_playState = PlayState::Quit;
-			return;
-		}
+Splashentation::LoadingTaskId Splashentation::addLoadingTask(const std::function<void()>& task, const float weight, const std::vector<LoadingTaskId>& dependencies)
+{
+	return m_loadingScheduler->addTask(task, weight, dependencies);
+}
 
-		// progression
-		if (m_moveOnToNextSlide)
-		{
-			m_moveOnToNextSlide = false;
-			m_clock.restart();
-			if (currentSlide == m_slides.begin())
-				previousSlide = currentSlide;
-			else
-				++previousSlide;
-			if (++currentSlide == m_slides.end())
-				isComplete = true;
-			else
-			{
-				std::lock_guard<std::mutex> lockGuard(m_informationMutex);
-				m_currentSlideIndex = static_cast<unsigned int>(currentSlide - m_slides.begin());
-			}
-		}
-	}
-	m_window->close();
-	std::lock_guard<std::mutex> lockGuard(m_playStateMutex);
-	m_playState = PlayState::Finished;
-	return;
+void Splashentation::clearLoadingTasks()
+{
+	m_loadingScheduler->cancel();
+	m_loadingScheduler->clearTasks();
 }
 
-void Splashentation::setupWindow(const sf::VideoMode& videoMode, const std::string& name, const unsigned int style, const sf::ContextSettings& contextSettings)
+void Splashentation::startLoading()
 {
-	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
-	m_windowSettings = { videoMode, name, style, contextSettings };
+	m_loadingScheduler->start();
 }
 
-sf::Vector2u Splashentation::getWindowSize() const
+void Splashentation::cancelLoading()
 {
-	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
-	return{ m_windowSettings.videoMode.width, m_windowSettings.videoMode.height };
+	m_loadingScheduler->cancel();
 }
 
-void Splashentation::addFont(const std::string& name, sf::Font& font)
+void Splashentation::waitForLoading()
 {
-	if (isPlaying())
-		return;
+	m_loadingScheduler->wait();
+}
 
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	fonts[name] = font;
+bool Splashentation::isLoadingCancelled() const
+{
+	return m_loadingScheduler->isCancelled();
 }
 
-bool Splashentation::loadFont(const std::string& name, const std::string& filename)
+Splashentation::LoadingProgress Splashentation::getLoadingProgress() const
 {
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	return (isPlaying() ? false : fonts[name].loadFromFile(filename));
+	// a host shows the progress of the application's loading
+	if (m_isHosting)
+	{
+		std::lock_guard<std::mutex> lockGuard(m_remoteLoadingProgressMutex);
+		if (m_hasRemoteLoadingProgress)
+			return m_remoteLoadingProgress;
+	}
+	return m_loadingScheduler->getProgress();
 }
 
-void Splashentation::removeFont(const std::string& name)
+void Splashentation::bindLoadingProgressToScale(const std::string& id)
 {
-	if (isPlaying())
-		return;
+	// ID must be supplied
+	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	fonts.erase(name);
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	m_loadingProgressBindings.push_back({ id, false, "" });
 }
 
-sf::Font* Splashentation::getFont(const std::string& name) const
+void Splashentation::bindLoadingProgressToString(const std::string& id, const std::string& prefix)
 {
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	return (isPlaying() ? nullptr : &fonts[name]);
+	// ID must be supplied
+	assert(id != "");
+
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	m_loadingProgressBindings.push_back({ id, true, prefix });
 }
 
-void Splashentation::addTexture(const std::string& name, sf::Texture& texture)
+void Splashentation::clearLoadingProgressBindings()
 {
-	if (isPlaying())
-		return;
-
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	textures[name] = texture;
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	m_loadingProgressBindings.clear();
 }
 
-bool Splashentation::loadTexture(const std::string& name, const std::string& filename)
+void Splashentation::setNextOnLoadingComplete(const bool enableNextOnLoadingComplete)
 {
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	return (isPlaying() ? false : textures[name].loadFromFile(filename));
+	m_isNextOnLoadingCompleteEnabled = enableNextOnLoadingComplete;
 }
 
-void Splashentation::removeTexture(const std::string& name)
+void Splashentation::setParallelPreparation(const std::size_t minimumNumberOfDrawables)
 {
 	if (isPlaying())
 		return;
 
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	textures.erase(name);
+	m_parallelPreparationThreshold = minimumNumberOfDrawables;
 }
 
-sf::Texture* Splashentation::getTexture(const std::string& name) const
+std::size_t Splashentation::getParallelPreparation() const
 {
-	std::lock_guard<std::mutex> lockGuard(resourceMutex);
-	return (isPlaying() ? nullptr : &textures[name]);
+	return m_parallelPreparationThreshold;
 }
 
-void Splashentation::addSlide(Slide& slide)
+void Splashentation::setDynamicResolution(const DynamicResolutionSettings& settings)
 {
 	if (isPlaying())
 		return;
 
-	m_slides.emplace_back(slide);
+	// scale must be within (0, 1]
+	assert((settings.minimumScale > 0.f) && (settings.minimumScale <= 1.f));
+
+	std::lock_guard<std::mutex> lockGuard(m_dynamicResolutionMutex);
+	m_dynamicResolution = settings;
 }
 
-void Splashentation::clearSlides()
+Splashentation::DynamicResolutionSettings Splashentation::getDynamicResolution() const
 {
-	if (isPlaying())
-		return;
+	std::lock_guard<std::mutex> lockGuard(m_dynamicResolutionMutex);
+	return m_dynamicResolution;
+}
 
-	m_slides.clear();
+float Splashentation::getRenderScale() const
+{
+	return m_renderScale;
 }
 
-void Splashentation::addGlobalControlAction(const ControlAction controlAction, const sf::Keyboard::Key key)
+void Splashentation::setRenderThreadSettings(const RenderThreadSettings& settings)
 {
 	if (isPlaying())
 		return;
 
-	if (m_globalKeys.count(key) == 0)
-		m_globalKeys[key] = controlAction;
+	assert(settings.cpuBudget >= 0.f);
+
+	{
+		std::lock_guard<std::mutex> lockGuard(m_renderThreadMutex);
+		m_renderThreadSettings = settings;
+	}
+	m_loadingScheduler->setBackgroundThreadSetup(priv_getHelperThreadSetup()); // background decoding
 }
 
-void Splashentation::removeGlobalControlAction(const sf::Keyboard::Key key)
+Splashentation::RenderThreadSettings Splashentation::getRenderThreadSettings() const
 {
-	if (isPlaying())
-		return;
+	std::lock_guard<std::mutex> lockGuard(m_renderThreadMutex);
+	return m_renderThreadSettings;
+}
 
-	m_globalKeys.erase(key);
+Splashentation::RenderThreadReport Splashentation::getRenderThreadReport() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_renderThreadMutex);
+	return m_renderThreadReport;
 }
 
-Splashentation::ControlAction Splashentation::getGlobalControlAction(const sf::Keyboard::Key key) const
+bool Splashentation::startRecording(const std::string& filename)
 {
-	if (isPlaying())
-		return ControlAction::None;
+	stopRecording();
+
+	std::unique_ptr<TraceWriter> traceWriter(new TraceWriter);
+	if (!traceWriter->open(filename))
+		return false;
 
-	const std::unordered_map<sf::Keyboard::Key, ControlAction>::const_iterator result{ m_globalKeys.find(key) };
-	return (result == m_globalKeys.end() ? ControlAction::None : result->second);
+	std::lock_guard<std::mutex> lockGuard(m_traceMutex);
+	m_traceWriter = std::move(traceWriter);
+	m_recordingStartTime = getSteadyTimeInMicroseconds();
+	m_isRecording = true;
+
+	// a recording started during playback is replayed from its start
+	if (isPlaying())
+	{
+		TraceRecord record(TraceRecord::Type::Play);
+		m_traceWriter->write(record);
+	}
+	return true;
 }
 
-void Splashentation::setGlobalMouseButtons(const ControlAction controlAction, const MouseButtons mouseButtons)
+void Splashentation::stopRecording()
 {
-	if (isPlaying())
+	std::lock_guard<std::mutex> lockGuard(m_traceMutex);
+	if (!m_traceWriter)
 		return;
 
-	m_globalMouseButtons[controlAction] = mouseButtons;
+	// end record marks how long the recording lasted
+	TraceRecord record(TraceRecord::Type::End);
+	record.time = getSteadyTimeInMicroseconds() - m_recordingStartTime;
+	m_traceWriter->write(record);
+	m_traceWriter->close();
+	m_traceWriter.reset();
+	m_isRecording = false;
 }
 
-Splashentation::MouseButtons Splashentation::getGlobalMouseButtons(const ControlAction controlAction) const
+bool Splashentation::isRecording() const
 {
-	if (isPlaying())
-		return MouseButtons::None;
-
-	const std::unordered_map<ControlAction, MouseButtons>::const_iterator result{ m_globalMouseButtons.find(controlAction) };
-	return (result == m_globalMouseButtons.end() ? MouseButtons::None : result->second);
+	return m_isRecording;
 }
 
-void Splashentation::addSlideControlAction(const unsigned int slideIndex, const ControlAction controlAction, const sf::Keyboard::Key key)
+Splashentation::ReplayReport Splashentation::replay(const std::string& filename, const ReplaySettings& settings)
 {
+	ReplayReport report;
 	if (isPlaying())
-		return;
+		return report;
+
+	TraceReader traceReader;
+	if (!traceReader.open(filename))
+		return report;
+
+	m_isHeadless = settings.isHeadless;
+	m_isReplaying = true;
+
+	// records made before play() was called are applied straight away. later records are timed from the play marker
+	TraceRecord record;
+	bool isRecordRead{ traceReader.read(record) };
+	while ((isRecordRead) && (record.type != TraceRecord::Type::Play) && (record.type != TraceRecord::Type::End))
+	{
+		priv_replayRecord(record);
+		++report.records;
+		isRecordRead = traceReader.read(record);
+	}
+	const sf::Int64 playTime{ (isRecordRead) ? record.time : 0 };
+	if ((isRecordRead) && (record.type == TraceRecord::Type::Play))
+	{
+		++report.records;
+		isRecordRead = traceReader.read(record);
+	}
+
+	play();
+	const sf::Int64 startTime{ getSteadyTimeInMicroseconds() };
+	sf::Int64 skippedTime{ 0 }; // microseconds. at maximum speed, the waits before input records are skipped
+	while ((isPlaying()) && (isRecordRead))
+	{
+		// waits in short steps so that a presentation that finishes by itself ends the replay
+		sf::Int64 delay{ startTime + record.time - playTime - skippedTime - getSteadyTimeInMicroseconds() };
+		if ((delay > 0) && (settings.isMaximumSpeed) && (record.isInput()))
+		{
+			skippedTime += delay;
+			delay = 0;
+		}
+		while ((delay > 0) && (isPlaying()))
+		{
+			sf::sleep(sf::microseconds(std::min(delay, sf::Int64(10000))));
+			delay = startTime + record.time - playTime - skippedTime - getSteadyTimeInMicroseconds();
+		}
+		++report.records;
+		if (record.type == TraceRecord::Type::End)
+			break;
+		priv_replayRecord(record);
+		isRecordRead = traceReader.read(record);
+	}
 
-	if (m_slides[slideIndex].keys.count(key) == 0)
-		m_slides[slideIndex].keys[key] = controlAction;
+	// the presentation is stopped where the trace ends (at its end record's time, or where it is damaged) unless it has already finished
+	if (isPlaying())
+		quit();
+	priv_waitForThreadToFinish();
+	report.isReplayed = true;
+	report.duration = sf::microseconds(getSteadyTimeInMicroseconds() - startTime);
+	report.frameTimings = getFrameTimings();
+	report.drawablesLock = getDrawablesLockContention();
+
+	m_isReplaying = false;
+	m_isHeadless = false;
+	std::lock_guard<std::mutex> lockGuard(m_replayEventsMutex);
+	m_replayEvents->events.clear();
+	return report;
 }
 
-void Splashentation::removeSlideControlAction(const unsigned int slideIndex, const sf::Keyboard::Key key)
+Splashentation::FrameTimings Splashentation::getFrameTimings() const
 {
-	if (isPlaying())
-		return;
+	std::lock_guard<std::mutex> lockGuard(m_frameTimingsMutex);
+	FrameTimings frameTimings{ m_frameTimings };
+	if (frameTimings.frames == 0u)
+		return frameTimings;
+
+	// percentiles from the histogram (upper end of the bucket, limited by the maximum)
+	auto getPercentile = [&](const float proportion)
+	{
+		const unsigned int rank{ static_cast<unsigned int>(std::ceil(proportion * frameTimings.frames)) };
+		unsigned int count{ 0u };
+		for (std::size_t bucket{ 0u }; bucket < m_frameTimeHistogram.size(); ++bucket)
+		{
+			count += m_frameTimeHistogram[bucket];
+			if (count >= rank)
+				return std::min(sf::milliseconds(static_cast<sf::Int32>(bucket + 1u)), frameTimings.maximum);
+		}
+		return frameTimings.maximum;
+	};
+	frameTimings.median = getPercentile(0.5f);
+	frameTimings.percentile99 = getPercentile(0.99f);
+	return frameTimings;
+}
 
-	m_slides[slideIndex].keys.erase(key);
+Splashentation::LockContention Splashentation::getDrawablesLockContention() const
+{
+	return m_drawablesMutex->getContention();
 }
 
-Splashentation::ControlAction Splashentation::getSlideControlAction(const unsigned int slideIndex, const sf::Keyboard::Key key) const
+bool Splashentation::hostRemote(const std::string& channelName)
 {
-	if (isPlaying())
-		return ControlAction::None;
+	if ((isPlaying()) || (m_isConnectedToHost))
+		return false;
 
-	const std::unordered_map<sf::Keyboard::Key, ControlAction>::const_iterator result{ m_slides[slideIndex].keys.find(key) };
-	return (result == m_slides[slideIndex].keys.end() ? ControlAction::None : result->second);
+	m_isHosting = false;
+	m_remoteChannel.reset(new RemoteChannel);
+	if (!m_remoteChannel->create(channelName, remoteChannelCapacity))
+	{
+		m_remoteChannel.reset();
+		return false;
+	}
+	m_remoteLoadingProgressMutex.lock();
+	m_remoteLoadingProgress = LoadingProgress();
+	m_hasRemoteLoadingProgress = false;
+	m_remoteLoadingProgressMutex.unlock();
+	m_isHosting = true;
+	return true;
 }
 
-void Splashentation::setSlideMouseButtons(const unsigned int slideIndex, const ControlAction controlAction, const MouseButtons mouseButtons)
+bool Splashentation::connectToHost(const std::string& channelName, const sf::Time timeout)
 {
-	if (isPlaying())
-		return;
+	disconnectFromHost();
+	if ((isPlaying()) || (m_isHosting))
+		return false;
+
+	// the host may not have created the channel yet
+	std::unique_ptr<RemoteChannel> remoteChannel(new RemoteChannel);
+	const sf::Int64 startTime{ getSteadyTimeInMicroseconds() };
+	while (!remoteChannel->open(channelName))
+	{
+		if (getSteadyTimeInMicroseconds() - startTime >= timeout.asMicroseconds())
+			return false;
+		sf::sleep(sf::milliseconds(50));
+	}
 
-	m_slides[slideIndex].mouseButtons[controlAction] = mouseButtons;
+	m_traceMutex.lock();
+	m_remoteChannel = std::move(remoteChannel);
+	m_traceMutex.unlock();
+	m_isHostGone = false;
+	m_isConnectedToHost = true;
+	m_hostExchangeThread = std::thread(&Splashentation::t_exchangeWithHost, this);
+	return true;
 }
 
-Splashentation::MouseButtons Splashentation::getSlideMouseButtons(const unsigned int slideIndex, const ControlAction controlAction) const
+void Splashentation::disconnectFromHost()
 {
-	if (isPlaying())
-		return MouseButtons::None;
+	if (!m_isConnectedToHost)
+		return;
 
-	const std::unordered_map<ControlAction, MouseButtons>::const_iterator result{ m_slides[slideIndex].mouseButtons.find(controlAction) };
-	return (result == m_slides[slideIndex].mouseButtons.end() ? MouseButtons::None : result->second);
+	m_isConnectedToHost = false;
+	if (m_hostExchangeThread.joinable())
+		m_hostExchangeThread.join();
+	std::lock_guard<std::mutex> lockGuard(m_traceMutex);
+	m_remoteChannel.reset();
+	if (m_playState == PlayState::Playing)
+		m_playState = PlayState::Quit;
 }
 
-bool Splashentation::isPlaying() const
+bool Splashentation::isConnectedToHost() const
 {
-	return (getPlayState() == PlayState::Playing);
+	return (m_isConnectedToHost) && (!m_isHostGone);
 }
 
-Splashentation::PlayState Splashentation::getPlayState() const
+void Splashentation::setCompositor(const Compositor compositor)
 {
-	std::lock_guard<std::mutex> lockGuard(m_playStateMutex);
-	return m_playState;
+	if (isPlaying())
+		return;
+
+	m_compositor = compositor;
 }
 
-sf::Time Splashentation::getSlideTime() const
+Splashentation::Compositor Splashentation::getCompositor() const
 {
-	std::lock_guard<std::mutex> lockGuard(m_clockMutex);
-	return m_clock.getElapsedTime();
+	return m_compositor;
 }
 
-unsigned int Splashentation::getCurrentSlideIndex() const
+const char* Splashentation::getSoftwareCompositorKernelName()
 {
-	std::lock_guard<std::mutex> lockGuard(m_informationMutex);
-	return m_currentSlideIndex;
+	return SoftwareCompositor::getKernelName();
 }
 
 
@@ -514,7 +2778,16 @@ void Splashentation::setDrawableZIndex(const std::string& id, const int newZInde
 	// ID must be supplied
 	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(m_drawablesMutex);
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::SetDrawableZIndex, id);
+		record.integer = newZIndex;
+		priv_recordTrace(record);
+	}
+	if (m_isConnectedToHost)
+		return; // applied by the host
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	priv_markDrawableChanged(id);
 	m_drawables[id].zIndex = newZIndex;
 }
 
@@ -527,7 +2800,16 @@ void Splashentation::setDrawableScale(const std::string& id, const sf::Vector2f
 	// ID must be supplied
 	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(m_drawablesMutex);
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::SetDrawableScale, id);
+		record.vector = newScale;
+		priv_recordTrace(record);
+	}
+	if (m_isConnectedToHost)
+		return; // applied by the host
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	priv_markDrawableChanged(id);
 	dynamic_cast<sf::Transformable*>(m_drawables[id].drawable.get())->setScale(newScale);
 }
 
@@ -536,7 +2818,16 @@ void Splashentation::setDrawablePosition(const std::string& id, const sf::Vector
 	// ID must be supplied
 	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(m_drawablesMutex);
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::SetDrawablePosition, id);
+		record.vector = newPosition;
+		priv_recordTrace(record);
+	}
+	if (m_isConnectedToHost)
+		return; // applied by the host
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	priv_markDrawableChanged(id);
 	dynamic_cast<sf::Transformable*>(m_drawables[id].drawable.get())->setPosition(newPosition);
 }
 
@@ -545,7 +2836,16 @@ void Splashentation::setDrawableOrigin(const std::string& id, const sf::Vector2f
 	// ID must be supplied
 	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(m_drawablesMutex);
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::SetDrawableOrigin, id);
+		record.vector = newOrigin;
+		priv_recordTrace(record);
+	}
+	if (m_isConnectedToHost)
+		return; // applied by the host
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	priv_markDrawableChanged(id);
 	dynamic_cast<sf::Transformable*>(m_drawables[id].drawable.get())->setOrigin(newOrigin);
 }
 
@@ -554,7 +2854,16 @@ void Splashentation::setDrawableRotation(const std::string& id, const float newR
 	// ID must be supplied
 	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(m_drawablesMutex);
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::SetDrawableRotation, id);
+		record.value = newRotation;
+		priv_recordTrace(record);
+	}
+	if (m_isConnectedToHost)
+		return; // applied by the host
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	priv_markDrawableChanged(id);
 	dynamic_cast<sf::Transformable*>(m_drawables[id].drawable.get())->setRotation(newRotation);
 }
 
@@ -567,14 +2876,323 @@ void Splashentation::setDrawableString(const std::string& id, const std::string&
 	// ID must be supplied
 	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(m_drawablesMutex);
-	static_cast<sf::Text*>(m_drawables[id].drawable.get())->setString(newString);
+	if ((m_isRecording) || (m_isConnectedToHost))
+	{
+		TraceRecord record(TraceRecord::Type::SetDrawableString, id);
+		record.string = newString;
+		priv_recordTrace(record);
+	}
+	if (m_isConnectedToHost)
+		return; // applied by the host
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	priv_markDrawableChanged(id);
+	sf::Drawable* drawable{ m_drawables[id].drawable.get() };
+	if (SdfText* sdfText = dynamic_cast<SdfText*>(drawable))
+		sdfText->setString(newString);
+	else
+		static_cast<sf::Text*>(drawable)->setString(newString);
 }
 
 
 
 // PRIVATE
 
+void Splashentation::priv_endPlay(const PlayState playState)
+{
+	// full resolution images still decoding are waited for (and uploaded while the context is still active) unless quitting
+	if (playState == PlayState::Quit)
+		m_progressiveTextureLoader->cancelAll();
+	else
+		m_progressiveTextureLoader->finish();
+
+	// with window handoff, a finished presentation leaves its final frame on screen for takeWindow(). the window belongs to the thread that
+	// called play() so it is not closed here (a quit presentation's window is closed by that thread in takeWindow() or the next play())
+	if (m_isWindowHandoffEnabled)
+		m_window->setActive(false); // release the context so that it can be activated by the receiving thread
+	else
+		m_window->close();
+	m_outputWindows.clear(); // output windows are never handed off
+	if (playState == PlayState::Quit)
+		cancelLoading();
+	m_playState = playState;
+	if (m_isHosting)
+		m_remoteChannel->setHostState(playState, m_currentSlideIndex, getSlideTime());
+}
+
+void Splashentation::priv_gatherDrawables(const CompactSlide& slide, std::vector<const OrderedDrawable*>& drawables)
+{
+	drawables.reserve(slide.ids.size() + slide.drawables.size());
+	for (auto& id : slide.ids)
+	{
+		if (m_drawables[id].drawable != nullptr)
+			drawables.push_back(&m_drawables[id]);
+	}
+	for (auto& drawable : slide.drawables)
+	{
+		if (drawable.drawable != nullptr)
+			drawables.push_back(&drawable);
+	}
+}
+
+void Splashentation::priv_applyLoadingProgressBindings(const float ratio)
+{
+	const std::string percentage{ std::to_string(static_cast<unsigned int>(std::ceil(ratio * 100.f))) + "%" };
+	for (auto& binding : m_loadingProgressBindings)
+	{
+		sf::Drawable* drawable{ m_drawables[binding.id].drawable.get() };
+		if (drawable == nullptr)
+			continue;
+		priv_markDrawableChanged(binding.id);
+		if (binding.isString)
+		{
+			if (SdfText* sdfText = dynamic_cast<SdfText*>(drawable))
+				sdfText->setString(binding.prefix + percentage);
+			else
+				static_cast<sf::Text*>(drawable)->setString(binding.prefix + percentage);
+		}
+		else
+		{
+			sf::Transformable* transformable{ dynamic_cast<sf::Transformable*>(drawable) };
+			if (transformable != nullptr)
+				transformable->setScale({ ratio, transformable->getScale().y });
+		}
+	}
+}
+
+Splashentation::DrawableInteraction& Splashentation::priv_getDrawableInteraction(const std::string& id)
+{
+	std::unordered_map<std::string, DrawableInteraction>::iterator interaction{ m_drawableInteractions.find(id) };
+	if (interaction != m_drawableInteractions.end())
+		return interaction->second;
+
+	++m_drawableInteractionsVersion;
+	return m_drawableInteractions.emplace(id, DrawableInteraction{ ControlAction::None, MouseButtons::None, nullptr, nullptr }).first->second;
+}
+
+void Splashentation::priv_addDrawable(const std::string& id, OrderedDrawable&& drawable)
+{
+	std::lock_guard<ContentionTrackingMutex> lockGuard(*m_drawablesMutex);
+	m_drawablesLayoutVersion = ++m_drawablesVersion;
+	m_drawables.emplace(id, std::move(drawable));
+}
+
+void Splashentation::priv_markDrawableChanged(const std::string& id)
+{
+	++m_drawablesVersion;
+	m_drawableChangeVersions[&m_drawables[id]] = m_drawablesVersion;
+
+	// only while playing (the render thread indexes every region when it starts)
+	if ((isPlaying()) && (m_drawableInteractions.find(id) != m_drawableInteractions.end()))
+		m_movedInteractiveDrawables.push_back(id);
+}
+
+Splashentation::MemoryReport Splashentation::priv_calculateMemoryReport() const
+{
+	MemoryReport report;
+	report.refusedLoads = m_memoryBudgetRefusals;
+
+	// render targets (window front and back buffers and the off-screen render texture, plus the buffers of any output windows and their composite texture)
+	m_windowSettingsMutex.lock();
+	const std::size_t renderTargetBytes{ estimateRenderTargetGpuMemory(m_windowSettings.videoMode, m_windowSettings.contextSettings) };
+	report.renderTargets = { sizeof(sf::RenderWindow) + sizeof(sf::RenderTexture), renderTargetBytes * 3u };
+	if (!m_outputWindowSettings.empty())
+		report.renderTargets += { sizeof(sf::RenderTexture), renderTargetBytes };
+	for (auto& outputSettings : m_outputWindowSettings)
+		report.renderTargets += { sizeof(sf::RenderWindow) + outputSettings.name.capacity(), estimateRenderTargetGpuMemory(outputSettings.videoMode, m_windowSettings.contextSettings) * 2u };
+	m_windowSettingsMutex.unlock();
+	report.total += report.renderTargets;
+
+	for (auto& texture : textures)
+	{
+		report.textures[texture.first] = { sizeof(sf::Texture) + texture.first.capacity(), estimateTextureGpuMemory(texture.second) };
+		report.total += report.textures[texture.first];
+	}
+
+	// glyph pages only exist for character sizes that have been used so only query sizes used by text drawables
+	std::unordered_map<const sf::Font*, std::vector<unsigned int>> fontCharacterSizes;
+	for (auto& drawable : m_drawables)
+	{
+		const sf::Text* text{ dynamic_cast<const sf::Text*>(drawable.second.drawable.get()) };
+		if ((text == nullptr) || (text->getFont() == nullptr))
+			continue;
+		std::vector<unsigned int>& characterSizes{ fontCharacterSizes[text->getFont()] };
+		if (std::find(characterSizes.begin(), characterSizes.end(), text->getCharacterSize()) == characterSizes.end())
+			characterSizes.push_back(text->getCharacterSize());
+	}
+	for (auto& font : fonts)
+	{
+		MemoryUsage usage{ sizeof(sf::Font) + font.first.capacity(), 0u };
+		const std::unordered_map<std::string, std::size_t>::const_iterator sourceSize{ fontSourceSizes.find(font.first) };
+		if (sourceSize != fontSourceSizes.end())
+			usage.cpuBytes += sourceSize->second;
+		const std::unordered_map<const sf::Font*, std::vector<unsigned int>>::const_iterator characterSizes{ fontCharacterSizes.find(&font.second) };
+		if (characterSizes != fontCharacterSizes.end())
+		{
+			for (auto& characterSize : characterSizes->second)
+				usage.gpuBytes += estimateTextureGpuMemory(font.second.getTexture(characterSize));
+		}
+		report.fonts[font.first] = usage;
+		report.total += usage;
+	}
+	// one atlas per font regardless of the sizes drawn
+	for (auto& sdfFont : sdfFonts)
+	{
+		report.sdfFonts[sdfFont.first] = { sdfFont.second.getMetricsMemory() + sdfFont.first.capacity(), estimateTextureGpuMemory(sdfFont.second.getTexture()) };
+		report.total += report.sdfFonts[sdfFont.first];
+	}
+
+	for (auto& drawable : m_drawables)
+	{
+		MemoryUsage usage{ sizeof(OrderedDrawable) + drawable.first.capacity(), 0u };
+		if (drawable.second.drawable != nullptr)
+			usage.cpuBytes += drawable.second.objectSize + estimateDrawableGeometryMemory(*drawable.second.drawable);
+		report.drawables[drawable.first] = usage;
+		report.total += usage;
+	}
+	report.total.cpuBytes += estimateUnorderedMapMemory(m_drawables);
+
+	report.slides.reserve(m_slides.size());
+	for (auto& slide : m_slides)
+	{
+		MemoryUsage slideData{ sizeof(CompactSlide) + slide.ids.capacity() * sizeof(std::string), 0u };
+		for (auto& id : slide.ids)
+			slideData.cpuBytes += id.capacity();
+		report.total += slideData;
+
+		MemoryUsage usage{ slideData };
+		for (auto& id : slide.ids)
+		{
+			const std::unordered_map<std::string, MemoryUsage>::const_iterator drawable{ report.drawables.find(id) };
+			if (drawable != report.drawables.end())
+				usage += drawable->second;
+		}
+		report.slides.push_back(usage);
+	}
+
+	// controls are shared by slides so are counted once
+	report.total.cpuBytes += estimateSlideControlsMemory(m_globalControls);
+	for (auto& controls : m_internedSlideControls)
+		report.total.cpuBytes += estimateSlideControlsMemory(*controls);
+
+	if (m_slideStreamer)
+	{
+		m_slideStreamer->forEachLoadedSlide([&report](const SlideStreamer::LoadedSlide& loadedSlide)
+		{
+			MemoryUsage usage{ sizeof(SlideStreamer::LoadedSlide) + loadedSlide.slide.ids.capacity() * sizeof(std::string), 0u };
+			for (auto& id : loadedSlide.slide.ids)
+				usage.cpuBytes += id.capacity();
+			for (auto& drawable : loadedSlide.slide.drawables)
+			{
+				usage.cpuBytes += sizeof(OrderedDrawable);
+				if (drawable.drawable != nullptr)
+					usage.cpuBytes += drawable.objectSize + estimateDrawableGeometryMemory(*drawable.drawable);
+			}
+			for (auto& texture : loadedSlide.textures)
+			{
+				usage.cpuBytes += sizeof(sf::Texture);
+				usage.gpuBytes += estimateTextureGpuMemory(*texture);
+			}
+			usage.cpuBytes += loadedSlide.fonts.size() * sizeof(sf::Font);
+			report.streamedSlides += usage;
+		});
+		report.total += report.streamedSlides;
+	}
+
+	report.progressiveLoads = m_progressiveTextureLoader->getMemoryUsage();
+	report.total += report.progressiveLoads;
+
+	std::size_t peak{ m_memoryPeak };
+	while ((report.total.getTotal() > peak) && (!m_memoryPeak.compare_exchange_weak(peak, report.total.getTotal()))) { }
+	report.peakTotal = std::max(peak, report.total.getTotal());
+	return report;
+}
+
+// a resource being replaced is still counted (it is only released once its replacement has loaded)
+bool Splashentation::priv_fitWithinMemoryBudget(const std::size_t newBytes)
+{
+	const std::size_t budget{ m_memoryBudget };
+	if (budget == 0u)
+		return true;
+	std::size_t total{ priv_calculateMemoryReport().total.getTotal() + newBytes };
+	if (total <= budget)
+		return true;
+
+	// only resources marked evictable are removed (drawables elsewhere, such as in streamed slides, can use resources without this knowing).
+	// those that added drawables still use are kept as well
+	if (m_memoryBudgetPolicy == MemoryBudgetPolicy::EvictUnused)
+	{
+		std::vector<const sf::Texture*> usedTextures;
+		std::vector<const sf::Font*> usedFonts;
+		std::vector<const SdfFont*> usedSdfFonts;
+		for (auto& drawable : m_drawables)
+		{
+			if (drawable.second.drawable == nullptr)
+				continue;
+			usedTextures.push_back(getDrawableTexture(*drawable.second.drawable));
+			if (const sf::Text* text = dynamic_cast<const sf::Text*>(drawable.second.drawable.get()))
+				usedFonts.push_back(text->getFont());
+			else if (const SdfText* sdfText = dynamic_cast<const SdfText*>(drawable.second.drawable.get()))
+				usedSdfFonts.push_back(sdfText->getFont());
+		}
+		for (std::unordered_set<std::string>::iterator name{ evictableTextures.begin() }; (total > budget) && (name != evictableTextures.end());)
+		{
+			const std::unordered_map<std::string, sf::Texture>::iterator texture{ textures.find(*name) };
+			if ((texture == textures.end()) || (std::find(usedTextures.begin(), usedTextures.end(), &texture->second) != usedTextures.end()))
+			{
+				++name;
+				continue;
+			}
+			m_progressiveTextureLoader->cancel(texture->second);
+			opaqueTextures.erase(&texture->second);
+			textures.erase(texture);
+			name = evictableTextures.erase(name);
+			total = priv_calculateMemoryReport().total.getTotal() + newBytes;
+		}
+		for (std::unordered_set<std::string>::iterator name{ evictableFonts.begin() }; (total > budget) && (name != evictableFonts.end());)
+		{
+			const std::unordered_map<std::string, sf::Font>::iterator font{ fonts.find(*name) };
+			if ((font == fonts.end()) || (std::find(usedFonts.begin(), usedFonts.end(), &font->second) != usedFonts.end()))
+			{
+				++name;
+				continue;
+			}
+			fontSourceSizes.erase(font->first);
+			fonts.erase(font);
+			name = evictableFonts.erase(name);
+			total = priv_calculateMemoryReport().total.getTotal() + newBytes;
+		}
+		for (std::unordered_set<std::string>::iterator name{ evictableSdfFonts.begin() }; (total > budget) && (name != evictableSdfFonts.end());)
+		{
+			const std::unordered_map<std::string, SdfFont>::iterator sdfFont{ sdfFonts.find(*name) };
+			if ((sdfFont == sdfFonts.end()) || (std::find(usedSdfFonts.begin(), usedSdfFonts.end(), &sdfFont->second) != usedSdfFonts.end()))
+			{
+				++name;
+				continue;
+			}
+			sdfFonts.erase(sdfFont);
+			name = evictableSdfFonts.erase(name);
+			total = priv_calculateMemoryReport().total.getTotal() + newBytes;
+		}
+		if (total <= budget)
+			return true;
+	}
+
+	// refuse the new resource (before it is loaded)
+	++m_memoryBudgetRefusals;
+	return false;
+}
+
+void Splashentation::priv_cancelPreparedThread()
+{
+	// a prepared render thread that was never played would otherwise wait forever
+	std::lock_guard<std::mutex> lockGuard(m_prepareMutex);
+	if (m_isPrepareRequested)
+	{
+		m_controlQuit = true;
+		m_prepareCondition.notify_one();
+	}
+}
+
 void Splashentation::priv_waitForThreadToFinish()
 {
 	if (m_playThread.joinable())
@@ -583,37 +3201,126 @@ void Splashentation::priv_waitForThreadToFinish()
 
 Splashentation::SlideState Splashentation::priv_getSlideState() const
 {
-	std::lock_guard<std::mutex> lockGuard(m_slideStateMutex);
 	return m_slideState;
 }
 
 void Splashentation::priv_setSlideState(SlideState slideState)
 {
-	std::lock_guard<std::mutex> lockGuard(m_slideStateMutex);
 	m_slideState = slideState;
 }
 
-bool Splashentation::priv_processKey(const std::pair<sf::Keyboard::Key, ControlAction> control, const sf::Keyboard::Key key, bool& foundKey)
+void Splashentation::priv_takePlayWindowSettings()
+{
+	// the previous presentation's windows are released first (a handed off window that was not taken belongs to this thread)
+	m_window.reset();
+	m_outputWindows.clear();
+	std::lock_guard<std::mutex> lockGuard(m_windowSettingsMutex);
+	m_playWindowSettings = m_windowSettings;
+	m_playOutputWindowSettings = m_outputWindowSettings;
+}
+
+void Splashentation::priv_startPlayThread()
+{
+	// slides are streamed from the slide source (loading starts straight away so that a prepared presentation has its first slides ready)
+	m_slideStreamer.reset();
+	if (m_slideSource)
+		m_slideStreamer.reset(new SlideStreamer(*m_slideSource, m_numberOfSlidesAhead, priv_getHelperThreadSetup()));
+	m_playThread = std::thread(&Splashentation::t_play, this);
+}
+
+Splashentation::CompactSlide Splashentation::priv_compactSlide(Slide&& slide, InternedSlideControls& internedSlideControls)
+{
+	SlideControls controls;
+	controls.keys = std::move(slide.keys);
+	controls.mouseButtons = std::move(slide.mouseButtons);
+
+	CompactSlide compactSlide;
+	compactSlide.color = slide.color;
+	compactSlide.duration = slide.duration;
+	compactSlide.transition = slide.transition;
+	compactSlide.ids = std::move(slide.ids);
+	compactSlide.ids.shrink_to_fit();
+	compactSlide.controls = priv_internSlideControls(controls, internedSlideControls);
+	return compactSlide;
+}
+
+std::shared_ptr<const Splashentation::SlideControls> Splashentation::priv_internSlideControls(const SlideControls& slideControls, InternedSlideControls& internedSlideControls)
+{
+	// controls no longer used by any slide are removed
+	internedSlideControls.erase(std::remove_if(internedSlideControls.begin(), internedSlideControls.end(),
+		[](const std::shared_ptr<const SlideControls>& controls) { return controls.use_count() == 1; }), internedSlideControls.end());
+
+	for (auto& controls : internedSlideControls)
+	{
+		if ((controls->keys == slideControls.keys) && (controls->mouseButtons == slideControls.mouseButtons))
+			return controls;
+	}
+	std::shared_ptr<SlideControls> controls{ std::make_shared<SlideControls>(slideControls) };
+	priv_compileControls(*controls);
+	internedSlideControls.push_back(controls);
+	return controls;
+}
+
+void Splashentation::priv_compileControls(SlideControls& slideControls)
 {
-	if ((foundKey) || (control.first != key))
+	slideControls.compiledKeys.assign(sf::Keyboard::KeyCount, ControlAction::None);
+	slideControls.compiledMouseButtons.assign(sf::Mouse::ButtonCount, ControlAction::None);
+
+	// when multiple actions share a mouse button, the most decisive one wins
+	const ControlAction mouseButtonControlActionsByPriority[]{ ControlAction::Quit, ControlAction::Skip, ControlAction::Next };
+	const std::pair<sf::Mouse::Button, MouseButtons> mouseButtonFlags[]{ { sf::Mouse::Left, MouseButtons::Left }, { sf::Mouse::Right, MouseButtons::Right }, { sf::Mouse::Middle, MouseButtons::Middle } };
+
+	for (auto& key : slideControls.keys)
+	{
+		if ((key.first >= 0) && (key.first < sf::Keyboard::KeyCount))
+			slideControls.compiledKeys[key.first] = key.second;
+	}
+	for (auto& mouseButtonFlag : mouseButtonFlags)
+	{
+		for (auto& controlAction : mouseButtonControlActionsByPriority)
+		{
+			const std::unordered_map<ControlAction, MouseButtons>::const_iterator buttons{ slideControls.mouseButtons.find(controlAction) };
+			if ((buttons != slideControls.mouseButtons.end()) && ((buttons->second & mouseButtonFlag.second) != 0))
+			{
+				slideControls.compiledMouseButtons[mouseButtonFlag.first] = controlAction;
+				break;
+			}
+		}
+	}
+}
+
+Splashentation::ControlAction Splashentation::priv_getCompiledKeyControlAction(const SlideControls& slideControls, const sf::Keyboard::Key key)
+{
+	if ((key < 0) || (key >= sf::Keyboard::KeyCount))
+		return ControlAction::None;
+	return slideControls.compiledKeys[key];
+}
+
+Splashentation::ControlAction Splashentation::priv_getCompiledMouseButtonControlAction(const SlideControls& slideControls, const sf::Mouse::Button mouseButton)
+{
+	if ((mouseButton < 0) || (mouseButton >= sf::Mouse::ButtonCount))
+		return ControlAction::None;
+	return slideControls.compiledMouseButtons[mouseButton];
+}
+
+bool Splashentation::priv_processControlAction(const ControlAction controlAction, bool& foundControl)
+{
+	if (foundControl)
 		return true;
 
-	std::lock_guard<std::mutex> lockGuard(m_playStateMutex);
-	switch (control.second)
+	switch (controlAction)
 	{
 	case ControlAction::Quit:
-		m_window->close();
-		m_playState = PlayState::Quit;
+		priv_endPlay(PlayState::Quit);
 		return false;
 	case ControlAction::Skip:
-		m_window->close();
-		m_playState = PlayState::Finished;
+		priv_endPlay(PlayState::Finished);
 		return false;
 	case ControlAction::Next:
 		if (priv_getSlideState() == SlideState::Show)
 		{
-			foundKey = true;
-			next();
+			foundControl = true;
+			priv_next();
 		}
 		break;
 	case ControlAction::None:
@@ -623,42 +3330,207 @@ bool Splashentation::priv_processKey(const std::pair<sf::Keyboard::Key, ControlA
 	return true;
 }
 
-bool Splashentation::priv_processMouseButton(const std::pair<ControlAction, MouseButtons> control, const sf::Mouse::Button mouseButton, bool& foundMouseButton)
+void Splashentation::priv_applyRenderThreadSettings(const RenderThreadSettings& settings)
 {
-	if (foundMouseButton)
-		return true;
+	bool isNicenessApplied{ false };
+	bool isAffinityApplied{ false };
+	priv_applyThreadScheduling(settings, isNicenessApplied, isAffinityApplied);
+
+	std::lock_guard<std::mutex> lockGuard(m_renderThreadMutex);
+	m_renderThreadReport = RenderThreadReport();
+	m_renderThreadReport.isNicenessApplied = isNicenessApplied;
+	m_renderThreadReport.isAffinityApplied = isAffinityApplied;
+}
+
+std::function<void()> Splashentation::priv_getHelperThreadSetup() const
+{
+	const RenderThreadSettings settings{ getRenderThreadSettings() };
+	if ((settings.niceness == 0) && (settings.cpuAffinity.empty()))
+		return nullptr;
 
-	MouseButtons mouseButtons
+	return [settings]()
 	{
-		static_cast<MouseButtons>
-		(((mouseButton == sf::Mouse::Button::Left) ? MouseButtons::Left : MouseButtons::None) |
-		((mouseButton == sf::Mouse::Button::Right) ? MouseButtons::Right : MouseButtons::None) |
-		((mouseButton == sf::Mouse::Button::Middle) ? MouseButtons::Middle : MouseButtons::None))
+		bool isNicenessApplied{ false };
+		bool isAffinityApplied{ false };
+		priv_applyThreadScheduling(settings, isNicenessApplied, isAffinityApplied);
 	};
-	if ((control.second & mouseButtons) == mouseButtons)
+}
+
+void Splashentation::priv_applyThreadScheduling(const RenderThreadSettings& settings, bool& isNicenessApplied, bool& isAffinityApplied)
+{
+	isNicenessApplied = false;
+	isAffinityApplied = false;
+#ifdef SPLASHENTATION_RENDER_THREAD_SCHEDULING
+	// on linux, niceness set for a thread id applies to that thread only
+	if (settings.niceness != 0)
+		isNicenessApplied = (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), settings.niceness) == 0);
+	if (!settings.cpuAffinity.empty())
 	{
-		std::lock_guard<std::mutex> lockGuard(m_playStateMutex);
-		switch (control.first)
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		for (auto& cpu : settings.cpuAffinity)
 		{
-		case ControlAction::Quit:
-			m_window->close();
-			m_playState = PlayState::Quit;
-			return false;
-		case ControlAction::Skip:
-			m_window->close();
-			m_playState = PlayState::Finished;
-			return false;
-		case ControlAction::Next:
-			if (priv_getSlideState() == SlideState::Show)
-			{
-				foundMouseButton = true;
-				next();
-			}
-			break;
-		case ControlAction::None:
-		default:
-			;
+			if (cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &cpus);
 		}
+		isAffinityApplied = (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0);
+	}
+#endif // SPLASHENTATION_RENDER_THREAD_SCHEDULING
+}
+
+void Splashentation::priv_recordFrameTime(const sf::Time frameTime)
+{
+	std::lock_guard<std::mutex> lockGuard(m_frameTimingsMutex);
+	++m_frameTimings.frames;
+	m_frameTimings.total += frameTime;
+	if (frameTime > m_frameTimings.maximum)
+		m_frameTimings.maximum = frameTime;
+	if (!m_frameTimeHistogram.empty())
+		++m_frameTimeHistogram[std::min(static_cast<std::size_t>(frameTime.asMilliseconds()), m_frameTimeHistogram.size() - 1u)];
+}
+
+void Splashentation::priv_next()
+{
+	m_moveOnToNextSlide = true;
+	priv_setSlideState(SlideState::In);
+}
+
+void Splashentation::priv_recordTrace(TraceRecord& record)
+{
+	std::lock_guard<std::mutex> lockGuard(m_traceMutex);
+
+	// timed inside the lock so that records are written in time order
+	record.time = getSteadyTimeInMicroseconds() - m_recordingStartTime;
+	if (m_traceWriter)
+		m_traceWriter->write(record);
+
+	// also sent to the host when connected
+	if ((m_isConnectedToHost) && (!m_isHostGone) && (!m_remoteChannel->send(record, remoteSendTimeout)))
+	{
+		m_isHostGone = true;
+		m_playState = PlayState::Quit;
+	}
+}
+
+void Splashentation::priv_recordEvent(const sf::Event& event)
+{
+	if (event.type == sf::Event::Closed)
+	{
+		TraceRecord record(TraceRecord::Type::Closed);
+		priv_recordTrace(record);
+	}
+	else if (event.type == sf::Event::KeyPressed)
+	{
+		TraceRecord record(TraceRecord::Type::KeyPressed);
+		record.integer = static_cast<sf::Int32>(event.key.code);
+		priv_recordTrace(record);
+	}
+	else if (event.type == sf::Event::MouseButtonPressed)
+	{
+		TraceRecord record(TraceRecord::Type::MouseButtonPressed);
+		record.integer = static_cast<sf::Int32>(event.mouseButton.button);
+		record.vector = { static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y) };
+		priv_recordTrace(record);
+	}
+	else if (event.type == sf::Event::MouseMoved)
+	{
+		TraceRecord record(TraceRecord::Type::MouseMoved);
+		record.vector = { static_cast<float>(event.mouseMove.x), static_cast<float>(event.mouseMove.y) };
+		priv_recordTrace(record);
 	}
+}
+
+bool Splashentation::priv_popReplayEvent(sf::Event& event)
+{
+	if (!m_isReplaying)
+		return false;
+
+	std::lock_guard<std::mutex> lockGuard(m_replayEventsMutex);
+	if (m_replayEvents->events.empty())
+		return false;
+	event = m_replayEvents->events.front();
+	m_replayEvents->events.pop_front();
 	return true;
 }
+
+void Splashentation::priv_replayRecord(const TraceRecord& record)
+{
+	sf::Event event;
+	switch (record.type)
+	{
+	case TraceRecord::Type::End:
+		quit();
+		return;
+	case TraceRecord::Type::SetDrawableZIndex:
+		setDrawableZIndex(record.id, record.integer);
+		return;
+	case TraceRecord::Type::SetDrawableScale:
+		setDrawableScale(record.id, record.vector);
+		return;
+	case TraceRecord::Type::SetDrawablePosition:
+		setDrawablePosition(record.id, record.vector);
+		return;
+	case TraceRecord::Type::SetDrawableOrigin:
+		setDrawableOrigin(record.id, record.vector);
+		return;
+	case TraceRecord::Type::SetDrawableRotation:
+		setDrawableRotation(record.id, record.value);
+		return;
+	case TraceRecord::Type::SetDrawableString:
+		setDrawableString(record.id, record.string);
+		return;
+	case TraceRecord::Type::Next:
+		next();
+		return;
+	case TraceRecord::Type::Skip:
+		skip();
+		return;
+	case TraceRecord::Type::Quit:
+		quit();
+		return;
+	case TraceRecord::Type::LoadingProgress:
+		{
+			std::lock_guard<std::mutex> lockGuard(m_remoteLoadingProgressMutex);
+			m_remoteLoadingProgress.ratio = record.value;
+			m_remoteLoadingProgress.isComplete = (record.integer != 0);
+			m_hasRemoteLoadingProgress = true;
+		}
+		return;
+	case TraceRecord::Type::KeyPressed:
+		event.type = sf::Event::KeyPressed;
+		event.key = sf::Event::KeyEvent();
+		event.key.code = static_cast<sf::Keyboard::Key>(record.integer);
+		break;
+	case TraceRecord::Type::MouseButtonPressed:
+		event.type = sf::Event::MouseButtonPressed;
+		event.mouseButton = sf::Event::MouseButtonEvent();
+		event.mouseButton.button = static_cast<sf::Mouse::Button>(record.integer);
+		event.mouseButton.x = static_cast<int>(record.vector.x);
+		event.mouseButton.y = static_cast<int>(record.vector.y);
+		break;
+	case TraceRecord::Type::MouseMoved:
+		event.type = sf::Event::MouseMoved;
+		event.mouseMove.x = static_cast<int>(record.vector.x);
+		event.mouseMove.y = static_cast<int>(record.vector.y);
+		break;
+	case TraceRecord::Type::Closed:
+		event.type = sf::Event::Closed;
+		break;
+	case TraceRecord::Type::Play:
+		return; // replay() plays the presentation at the marker
+	}
+
+	// input events are handled by the render thread
+	std::lock_guard<std::mutex> lockGuard(m_replayEventsMutex);
+	m_replayEvents->events.push_back(event);
+}
+
+void Splashentation::priv_recordInputLatency(const sf::Time latency)
+{
+	std::lock_guard<std::mutex> lockGuard(m_inputLatencyMutex);
+	m_inputLatency.last = latency;
+	m_inputLatency.total += latency;
+	if (latency > m_inputLatency.maximum)
+		m_inputLatency.maximum = latency;
+	++m_inputLatency.count;
+}
@@ -34,12 +34,15 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <functional>
 //#include <initializer_list>
 #include <assert.h>
 
 // thread
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 // SFML
 #include <SFML/Window/VideoMode.hpp>
@@ -58,6 +61,8 @@ namespace sf
 	
 class RenderWindow;
 class Font;
+class Texture;
+class Event;
 
 } // namespace sf
 
@@ -79,6 +84,11 @@ public:
 		Skip,
 		Quit,
 	};
+	enum class Compositor
+	{
+		Standard, // slides are drawn and blended by the GPU every frame
+		Software, // slides are drawn only when they change and are blended on the CPU (suits targets without a GPU)
+	};
 	enum MouseButtons
 	{
 		None = 0,
@@ -90,11 +100,134 @@ public:
 	{
 		std::unique_ptr<sf::Drawable> drawable;
 		int zIndex;
-		OrderedDrawable() : drawable(nullptr), zIndex(0) { }
+		std::size_t objectSize; // size of the concrete drawable type (for memory accounting)
+		OrderedDrawable() : drawable(nullptr), zIndex(0), objectSize(0u) { }
 		template <class drawableT>
-		explicit OrderedDrawable(drawableT& newDrawable, const int newZIndex = 0) : zIndex(newZIndex), drawable(new drawableT(newDrawable)) {}
+		explicit OrderedDrawable(drawableT& newDrawable, const int newZIndex = 0) : zIndex(newZIndex), drawable(new drawableT(newDrawable)), objectSize(sizeof(drawableT)) {}
 		template <class drawableT>
-		explicit OrderedDrawable(std::unique_ptr<drawableT>& newDrawable, const int newZIndex = 0) : zIndex(newZIndex), drawable(std::move(newDrawable)) {}
+		explicit OrderedDrawable(std::unique_ptr<drawableT>& newDrawable, const int newZIndex = 0) : zIndex(newZIndex), drawable(std::move(newDrawable)), objectSize(sizeof(drawableT)) {}
+	};
+	struct MemoryUsage
+	{
+		std::size_t cpuBytes;
+		std::size_t gpuBytes; // estimated
+		MemoryUsage() : cpuBytes(0u), gpuBytes(0u) { }
+		MemoryUsage(const std::size_t newCpuBytes, const std::size_t newGpuBytes) : cpuBytes(newCpuBytes), gpuBytes(newGpuBytes) { }
+		std::size_t getTotal() const { return cpuBytes + gpuBytes; }
+		MemoryUsage& operator+=(const MemoryUsage& other) { cpuBytes += other.cpuBytes; gpuBytes += other.gpuBytes; return *this; }
+	};
+	struct MemoryReport
+	{
+		std::unordered_map<std::string, MemoryUsage> textures;
+		std::unordered_map<std::string, MemoryUsage> fonts;
+		std::unordered_map<std::string, MemoryUsage> sdfFonts;
+		std::unordered_map<std::string, MemoryUsage> drawables;
+		std::vector<MemoryUsage> slides; // slide data and the drawables it shows (resources are not included)
+		MemoryUsage renderTargets; // window and off-screen render texture
+		MemoryUsage streamedSlides; // slides currently loaded from the slide source (including their drawables and resources)
+		MemoryUsage progressiveLoads; // decoded full resolution images waiting to replace their placeholders
+		MemoryUsage total; // resources, drawables, slides and render targets (shared items counted once)
+		std::size_t peakTotal; // highest total seen (including during playback)
+		unsigned int refusedLoads; // loads refused because of the memory budget
+	};
+	enum class MemoryBudgetPolicy
+	{
+		Refuse, // loads that would exceed the budget fail
+		EvictUnused, // resources marked evictable (that no added drawable uses) are removed to make room; otherwise refuse
+	};
+	struct InputLatency
+	{
+		sf::Time last;
+		sf::Time maximum;
+		sf::Time total;
+		unsigned int count;
+		InputLatency() : last(sf::Time::Zero), maximum(sf::Time::Zero), total(sf::Time::Zero), count(0u) { }
+		sf::Time getAverage() const { return (count == 0u) ? sf::Time::Zero : total / static_cast<float>(count); }
+	};
+	struct StartupTimes
+	{
+		sf::Time threadStart; // from prepare() (or play() if not prepared) until the render thread starts
+		sf::Time windowCreation; // after play() (a prepared window is not created until then)
+		sf::Time renderTextureCreation;
+		sf::Time waitForPlay; // time the prepared render thread spent waiting for play()
+		sf::Time firstFrame; // from play() until the first frame is displayed
+		sf::Time total; // from prepare() (or play() if not prepared) until the first frame is displayed
+		StartupTimes() : threadStart(sf::Time::Zero), windowCreation(sf::Time::Zero), renderTextureCreation(sf::Time::Zero), waitForPlay(sf::Time::Zero), firstFrame(sf::Time::Zero), total(sf::Time::Zero) { }
+	};
+	typedef std::size_t LoadingTaskId;
+	struct LoadingProgress
+	{
+		float ratio; // completed weight / total weight
+		sf::Time elapsed;
+		sf::Time estimatedRemaining;
+		float tasksPerSecond;
+		std::size_t completedTasks;
+		std::size_t failedTasks; // tasks that threw an exception (counted as completed)
+		std::size_t totalTasks;
+		bool isComplete;
+		bool isCancelled;
+		LoadingProgress() : ratio(0.f), elapsed(sf::Time::Zero), estimatedRemaining(sf::Time::Zero), tasksPerSecond(0.f), completedTasks(0u), failedTasks(0u), totalTasks(0u), isComplete(false), isCancelled(false) { }
+	};
+	struct DynamicResolutionSettings
+	{
+		bool isEnabled;
+		float minimumScale; // lowest render scale used during transitions (0 - 1]
+		sf::Time targetFrameTime; // frame rate is limited to this
+		float reduceThreshold; // render scale is reduced when frame work takes longer than this proportion of the target frame time
+		float increaseThreshold; // render scale is increased when frame work takes less than this proportion of the target frame time
+		unsigned int framesBetweenChanges;
+		DynamicResolutionSettings() : isEnabled(false), minimumScale(0.5f), targetFrameTime(sf::seconds(1.f / 60.f)), reduceThreshold(0.9f), increaseThreshold(0.6f), framesBetweenChanges(10u) { }
+	};
+	struct RenderThreadSettings
+	{
+		int niceness; // (Linux) applied to every thread the splash starts (render, frame preparation, slide streaming and background decoding). 0 leaves it unchanged
+		std::vector<unsigned int> cpuAffinity; // (Linux) CPUs the threads the splash starts may run on. empty allows any
+		float cpuBudget; // proportion of one core the render thread may use (e.g. 0.1 is 10%). 0 is unlimited. measured on the render thread only (the other threads are only limited by niceness and affinity)
+		RenderThreadSettings() : niceness(0), cpuBudget(0.f) { }
+	};
+	struct RenderThreadReport
+	{
+		bool isNicenessApplied;
+		bool isAffinityApplied;
+		float cpuUsage; // proportion of one core used by the render thread (over the last measurement period)
+		float frameRateLimit;
+		bool areTransitionsDisabled; // transitions are shown as cuts
+		bool isDegraded; // frame rate or effects are currently reduced to stay within the CPU budget
+		unsigned int degradations; // number of times frame rate or effects had to be reduced
+		RenderThreadReport() : isNicenessApplied(false), isAffinityApplied(false), cpuUsage(0.f), frameRateLimit(0.f), areTransitionsDisabled(false), isDegraded(false), degradations(0u) { }
+	};
+	struct FrameTimings
+	{
+		unsigned int frames;
+		sf::Time total;
+		sf::Time maximum;
+		sf::Time median; // percentiles have a resolution of 1 millisecond
+		sf::Time percentile99;
+		FrameTimings() : frames(0u), total(sf::Time::Zero), maximum(sf::Time::Zero), median(sf::Time::Zero), percentile99(sf::Time::Zero) { }
+		sf::Time getAverage() const { return (frames == 0u) ? sf::Time::Zero : total / static_cast<float>(frames); }
+	};
+	struct LockContention
+	{
+		sf::Uint64 acquisitions;
+		sf::Uint64 contentions; // acquisitions that had to wait
+		sf::Time totalWait;
+		sf::Time maximumWait;
+		LockContention() : acquisitions(0u), contentions(0u), totalWait(sf::Time::Zero), maximumWait(sf::Time::Zero) { }
+	};
+	struct ReplaySettings
+	{
+		bool isMaximumSpeed; // the idle time before each input event is skipped. other records keep their timing (relative to the previous record) and the presentation still runs until it finishes or the trace ends
+		bool isHeadless; // window is kept hidden
+		ReplaySettings() : isMaximumSpeed(false), isHeadless(true) { }
+	};
+	struct ReplayReport
+	{
+		bool isReplayed;
+		std::size_t records;
+		sf::Time duration;
+		FrameTimings frameTimings;
+		LockContention drawablesLock;
+		ReplayReport() : isReplayed(false), records(0u), duration(sf::Time::Zero) { }
 	};
 	class Slide
 	{
@@ -107,32 +240,74 @@ public:
 		std::unordered_map<ControlAction, MouseButtons> mouseButtons;
 
 		Slide() : color(sf::Color::Black), duration(sf::seconds(5.f)), transition(sf::seconds(2.f)) { }
-		Slide(Slide& slide) : color(slide.color), duration(slide.duration), transition(slide.transition), ids(slide.ids), keys(slide.keys), mouseButtons(slide.mouseButtons) { }
+		Slide(Slide&& slide) = default;
+		Slide& operator=(Slide&& slide) = default;
+		Slide(const Slide&) = delete;
+		Slide& operator=(const Slide&) = delete;
 		void add(const std::string& id) { ids.emplace_back(id); }
 		void clear() { ids.clear(); }
 	};
+	struct SlideContent
+	{
+		Slide slide; // ids can refer to drawables added to splashentation as well as drawables here
+		std::vector<OrderedDrawable> drawables; // drawables used only by this slide (always drawn)
+		std::vector<std::unique_ptr<sf::Texture>> textures; // resources used only by this slide (released with it)
+		std::vector<std::unique_ptr<sf::Font>> fonts;
+	};
+	// provides slides on demand so that only the slides around the current one are held in memory
+	class SdfFont; // signed distance field font (SdfText.hpp)
+	class SdfText;
+	class SlideSource
+	{
+	public:
+		virtual ~SlideSource() { }
+		virtual std::size_t getNumberOfSlides() const = 0;
+		virtual void loadSlide(std::size_t index, SlideContent& content) = 0; // called on a loading thread. if it throws, an empty slide is shown
+	};
 
 	Splashentation(const sf::VideoMode& videoMode = sf::VideoMode(64, 64), const std::string& name = "", unsigned int style = sf::Style::None, const sf::ContextSettings& contextSettings = sf::ContextSettings());
 	~Splashentation();
 
 	void clearAllResources();
 
+	void prepare(); // starts the render thread and creates its off-screen targets in advance. the window is not created (so nothing is shown) until play()
 	void play();
 	void next(); // next slide
 	void skip();
 	void quit();
-	void setupWindow(const sf::VideoMode& videoMode = sf::VideoMode(64, 64), const std::string& name = "", unsigned int style = sf::Style::None, const sf::ContextSettings& contextSettings = sf::ContextSettings());
+	void setupWindow(const sf::VideoMode& videoMode = sf::VideoMode(64, 64), const std::string& name = "", unsigned int style = sf::Style::None, const sf::ContextSettings& contextSettings = sf::ContextSettings()); // takes effect from the next prepare() (or play() if not prepared)
 	sf::Vector2u getWindowSize() const;
+	void setWindowHandoff(bool enableWindowHandoff); // if enabled, the window is kept open (showing the final frame) when the presentation finishes. the window is then created by play() so that it belongs to the calling thread (on some platforms, a window is destroyed with the thread that created it and only that thread receives its events, so input during the presentation may not be received)
+	bool getWindowHandoff() const;
+	std::unique_ptr<sf::RenderWindow> takeWindow(); // waits for the presentation to end (a prepared presentation that has not been played is cancelled). returns nullptr if there is no open window to hand off (a quit presentation's window is closed here)
+	void addOutputWindow(const sf::VideoMode& videoMode, sf::Vector2i position, const std::string& name = "", unsigned int style = sf::Style::None); // each frame is composed once and shown in the window and every output window (scaled to fit). takes effect from the next prepare() (or play() if not prepared)
+	void clearOutputWindows();
+	std::size_t getNumberOfOutputWindows() const;
 	void addFont(const std::string& name, sf::Font& font);
 	bool loadFont(const std::string& name, const std::string& filename);
 	void removeFont(const std::string& name);
+	void setFontEvictable(const std::string& name, bool isEvictable = true); // the memory budget may remove an evictable font (see MemoryBudgetPolicy::EvictUnused). only mark fonts that nothing will draw with
 	sf::Font* getFont(const std::string& name) const;
+	bool loadSdfFont(const std::string& name, const std::string& filename); // builds the distance field atlas (or reads it from the decoded image cache directory if enabled)
+	void removeSdfFont(const std::string& name);
+	void setSdfFontEvictable(const std::string& name, bool isEvictable = true);
+	SdfFont* getSdfFont(const std::string& name) const;
 	void addTexture(const std::string& name, sf::Texture& texture);
 	bool loadTexture(const std::string& name, const std::string& filename);
+	bool loadTextureProgressively(const std::string& name, const std::string& filename); // shows a low resolution placeholder (see below) while the full image is decoded in the background and swapped in while a slide is shown
 	void removeTexture(const std::string& name);
+	void setTextureEvictable(const std::string& name, bool isEvictable = true); // the memory budget may remove an evictable texture (see MemoryBudgetPolicy::EvictUnused). only mark textures that nothing will draw with
 	sf::Texture* getTexture(const std::string& name) const;
-	void addSlide(Slide& slide);
+	void enableDecodedImageCache(const std::string& directory, unsigned int maximumSize = 0u); // maximum size of 0 keeps original size. also stores thumbnails used as progressive loading placeholders (jpeg exif thumbnails are used otherwise)
+	void disableDecodedImageCache();
+	bool isDecodedImageCacheEnabled() const;
+	MemoryReport getMemoryReport() const;
+	void setMemoryBudget(std::size_t bytes, MemoryBudgetPolicy policy = MemoryBudgetPolicy::Refuse); // 0 is unlimited. budget applies to estimated total (CPU + GPU). loads are checked (from image headers or file sizes) before they allocate
+	std::size_t getMemoryBudget() const;
+	void addSlide(Slide&& slide);
+	void addSlide(const Slide& slide); // copies the slide (so that it can be changed and added again)
 	void clearSlides();
+	void setSlideSource(std::unique_ptr<SlideSource> slideSource, std::size_t numberOfSlidesAhead = 2u); // used instead of added slides. at least one slide is loaded ahead. nullptr returns to added slides. ignored while prepared or playing
 
 	void addGlobalControlAction(ControlAction controlAction, sf::Keyboard::Key key);
 	void removeGlobalControlAction(sf::Keyboard::Key key);
@@ -146,16 +321,70 @@ public:
 	void setSlideMouseButtons(unsigned int slideIndex, ControlAction controlAction, MouseButtons mouseButtons);
 	MouseButtons getSlideMouseButtons(unsigned int slideIndex, ControlAction controlAction) const;
 
+	// interactive drawables (the topmost interactive drawable of the current slide under the mouse responds before slide and global controls)
+	void setDrawableClickAction(const std::string& id, ControlAction controlAction, MouseButtons mouseButtons = MouseButtons::Left, const std::function<void()>& callback = nullptr); // callback is called on the render thread
+	void setDrawableHoverCallback(const std::string& id, const std::function<void(bool)>& callback); // called on the render thread with true when the mouse enters the drawable and false when it leaves
+	void removeDrawableInteraction(const std::string& id);
+	std::string getHoveredDrawable() const; // empty if the mouse is not over an interactive drawable
+
 	bool isPlaying() const;
 	PlayState getPlayState() const;
 	sf::Time getSlideTime() const;
 	unsigned int getCurrentSlideIndex() const;
+	InputLatency getInputLatency() const; // time from receiving an input event to displaying its result
+	StartupTimes getStartupTimes() const;
 
 
 
 	template <class drawableT>
 	void addDrawable(const std::string& id, drawableT& drawable, const int zIndex = 0);
 
+	// loading (tasks run on a thread pool using all but one core; quitting cancels tasks that have not started)
+	LoadingTaskId addLoadingTask(const std::function<void()>& task, float weight = 1.f, const std::vector<LoadingTaskId>& dependencies = std::vector<LoadingTaskId>());
+	void clearLoadingTasks();
+	void startLoading();
+	void cancelLoading();
+	void waitForLoading();
+	bool isLoadingCancelled() const; // long tasks can check this to stop early
+	LoadingProgress getLoadingProgress() const;
+	void bindLoadingProgressToScale(const std::string& id); // horizontal scale of the drawable follows progress
+	void bindLoadingProgressToString(const std::string& id, const std::string& prefix); // text drawable shows prefix followed by progress percentage
+	void clearLoadingProgressBindings();
+	void setNextOnLoadingComplete(bool enableNextOnLoadingComplete); // slides without a duration progress when loading completes
+
+	// parallel preparation (geometry of sprites, shapes and vertex arrays is transformed and batched on worker threads)
+	void setParallelPreparation(std::size_t minimumNumberOfDrawables); // 0 disables. applies to frames showing at least this many drawables
+	std::size_t getParallelPreparation() const;
+
+	// dynamic resolution (transitions are rendered at a reduced resolution when needed to keep to the target frame time)
+	void setDynamicResolution(const DynamicResolutionSettings& settings);
+	DynamicResolutionSettings getDynamicResolution() const;
+	float getRenderScale() const; // current render scale (1 is full resolution)
+
+	// render thread (scheduling and CPU budget. the budget is kept by lowering frame rate and then by disabling transitions)
+	void setRenderThreadSettings(const RenderThreadSettings& settings);
+	RenderThreadSettings getRenderThreadSettings() const;
+	RenderThreadReport getRenderThreadReport() const;
+
+	// record and replay (drawable changes, next/skip/quit and input events during playback are recorded with their times to a binary trace)
+	bool startRecording(const std::string& filename);
+	void stopRecording();
+	bool isRecording() const;
+	ReplayReport replay(const std::string& filename, const ReplaySettings& settings = ReplaySettings()); // plays the presentation (set up as it was when recorded) driven by the trace. blocks until finished
+	FrameTimings getFrameTimings() const; // time between displayed frames (since play)
+	LockContention getDrawablesLockContention() const; // since play
+
+	// remote (the presentation is played by a host process; an application connects to it and sends drawable changes, next/skip/quit and loading progress through shared memory)
+	bool hostRemote(const std::string& channelName); // host. call before play. the presentation follows the application that connects
+	bool connectToHost(const std::string& channelName, sf::Time timeout = sf::seconds(5.f)); // application. waits up to timeout for the host to create the channel
+	void disconnectFromHost();
+	bool isConnectedToHost() const; // false once the host has finished or gone
+
+	// compositor
+	void setCompositor(Compositor compositor);
+	Compositor getCompositor() const;
+	static const char* getSoftwareCompositorKernelName(); // "AVX2", "SSE2" or "scalar" (chosen at runtime)
+
 	// zIndex
 	void setDrawableZIndex(const std::string& id, int zIndex);
 
@@ -165,10 +394,44 @@ public:
 	void setDrawableOrigin(const std::string& id, sf::Vector2f newOrigin);
 	void setDrawableRotation(const std::string& id, float newRotation);
 
-	// text
+	// text (sf::Text or SdfText)
 	void setDrawableString(const std::string& id, const std::string& newString);
 
 private:
+	class LoadingScheduler;
+	class FramePreparer;
+	class SoftwareCompositor;
+	class SlideStreamer;
+	class ProgressiveTextureLoader;
+	class TraceWriter;
+	class TraceReader;
+	struct TraceRecord;
+	class RemoteChannel;
+	class RegionIndex;
+	class ContentionTrackingMutex;
+	struct ReplayEvents;
+
+	// controls of a slide (or the global controls) and their lookup tables. slides with identical controls share them
+	struct SlideControls
+	{
+		std::unordered_map<sf::Keyboard::Key, ControlAction> keys;
+		std::unordered_map<ControlAction, MouseButtons> mouseButtons;
+		std::vector<ControlAction> compiledKeys; // indexed by key
+		std::vector<ControlAction> compiledMouseButtons; // indexed by mouse button
+	};
+	typedef std::vector<std::shared_ptr<const SlideControls>> InternedSlideControls;
+
+	// slide as stored for playback
+	struct CompactSlide
+	{
+		sf::Color color;
+		sf::Time duration;
+		sf::Time transition;
+		std::vector<std::string> ids;
+		std::vector<OrderedDrawable> drawables; // drawables owned by the slide (from a slide source)
+		std::shared_ptr<const SlideControls> controls;
+	};
+
 	struct WindowSettings
 	{
 		sf::VideoMode videoMode;
@@ -176,24 +439,88 @@ private:
 		unsigned int style;
 		sf::ContextSettings contextSettings;
 	} m_windowSettings;
+	struct OutputWindowSettings
+	{
+		sf::VideoMode videoMode;
+		sf::Vector2i position;
+		std::string name;
+		unsigned int style;
+	};
+	std::vector<OutputWindowSettings> m_outputWindowSettings; // guarded by m_windowSettingsMutex
+	WindowSettings m_playWindowSettings; // taken when the render thread is started (used by it and by play())
+	std::vector<OutputWindowSettings> m_playOutputWindowSettings;
+
+	struct DecodedImageCacheSettings
+	{
+		bool isEnabled;
+		std::string directory;
+		unsigned int maximumSize;
+	} m_decodedImageCacheSettings;
 
 	enum class SlideState
 	{
 		In,
 		Show,
-	} m_slideState{ SlideState::In };
+	};
 
 	std::unordered_map<std::string, OrderedDrawable> m_drawables;
 	std::unique_ptr<sf::RenderWindow> m_window;
-	sf::Clock m_clock;
-	std::vector<Slide> m_slides;
-	PlayState m_playState;
-	bool m_moveOnToNextSlide;
-	bool m_controlSkip;
-	bool m_controlQuit;
-	unsigned int m_currentSlideIndex;
-	std::unordered_map<sf::Keyboard::Key, ControlAction> m_globalKeys;
-	std::unordered_map<ControlAction, MouseButtons> m_globalMouseButtons;
+	std::vector<std::unique_ptr<sf::RenderWindow>> m_outputWindows; // used by the render thread only
+	std::vector<CompactSlide> m_slides;
+	InternedSlideControls m_internedSlideControls;
+	std::unique_ptr<SlideSource> m_slideSource;
+	std::size_t m_numberOfSlidesAhead{ 2u };
+	std::unique_ptr<SlideStreamer> m_slideStreamer; // created for each playback when there is a slide source
+	std::unique_ptr<LoadingScheduler> m_loadingScheduler;
+	std::unique_ptr<ProgressiveTextureLoader> m_progressiveTextureLoader;
+	struct LoadingProgressBinding
+	{
+		std::string id;
+		bool isString;
+		std::string prefix;
+	};
+	std::vector<LoadingProgressBinding> m_loadingProgressBindings; // guarded by m_drawablesMutex
+	struct DrawableInteraction
+	{
+		ControlAction clickAction;
+		MouseButtons clickMouseButtons;
+		std::function<void()> clickCallback;
+		std::function<void(bool)> hoverCallback;
+	};
+	std::unordered_map<std::string, DrawableInteraction> m_drawableInteractions; // guarded by m_drawablesMutex
+	sf::Uint64 m_drawableInteractionsVersion{ 0u }; // guarded by m_drawablesMutex. increases when drawables become (or stop being) interactive
+	std::vector<std::string> m_movedInteractiveDrawables; // guarded by m_drawablesMutex. interactive drawables changed since the render thread last updated their hit regions
+	std::string m_hoveredDrawable; // guarded by m_drawablesMutex
+	std::atomic<bool> m_isNextOnLoadingCompleteEnabled{ false };
+	std::atomic<std::size_t> m_parallelPreparationThreshold{ 0u };
+	std::atomic<Compositor> m_compositor{ Compositor::Standard };
+	DynamicResolutionSettings m_dynamicResolution;
+	std::atomic<float> m_renderScale{ 1.f };
+	RenderThreadSettings m_renderThreadSettings;
+	RenderThreadReport m_renderThreadReport;
+	sf::Uint64 m_drawablesVersion{ 0u }; // guarded by m_drawablesMutex. increases whenever any drawable changes
+	sf::Uint64 m_drawablesLayoutVersion{ 0u }; // guarded by m_drawablesMutex. m_drawablesVersion when drawables, slides or textures last changed other than by a single drawable's setter
+	std::unordered_map<const OrderedDrawable*, sf::Uint64> m_drawableChangeVersions; // guarded by m_drawablesMutex. m_drawablesVersion when each drawable was last changed by a setter (or a progress binding)
+	std::atomic<std::size_t> m_memoryBudget{ 0u };
+	std::atomic<MemoryBudgetPolicy> m_memoryBudgetPolicy{ MemoryBudgetPolicy::Refuse };
+	mutable std::atomic<std::size_t> m_memoryPeak{ 0u };
+	std::atomic<unsigned int> m_memoryBudgetRefusals{ 0u };
+	SlideControls m_globalControls; // compiled when played
+	InputLatency m_inputLatency;
+	std::vector<unsigned int> m_frameTimeHistogram; // frames counted in 1 millisecond buckets (last bucket includes all longer frames)
+	FrameTimings m_frameTimings; // frames, total and maximum
+	std::unique_ptr<TraceWriter> m_traceWriter;
+	sf::Int64 m_recordingStartTime{ 0 }; // microseconds (steady clock)
+	std::atomic<bool> m_isRecording{ false };
+	std::atomic<bool> m_isReplaying{ false };
+	std::atomic<bool> m_isHeadless{ false };
+	std::unique_ptr<ReplayEvents> m_replayEvents; // input events from a replay waiting for the render thread
+	std::unique_ptr<RemoteChannel> m_remoteChannel;
+	std::atomic<bool> m_isHosting{ false };
+	std::atomic<bool> m_isConnectedToHost{ false };
+	std::atomic<bool> m_isHostGone{ false }; // the host finished, quit or stopped publishing its state
+	LoadingProgress m_remoteLoadingProgress; // guarded by m_remoteLoadingProgressMutex. received from the application
+	bool m_hasRemoteLoadingProgress{ false };
 
 
 
@@ -202,21 +529,69 @@ private:
 	// thread
 
 	std::thread m_playThread;
-	mutable std::mutex m_playStateMutex;
+	std::thread m_hostExchangeThread;
 	mutable std::mutex m_windowSettingsMutex;
-	mutable std::mutex m_drawablesMutex;
-	mutable std::mutex m_clockMutex;
-	mutable std::mutex m_controlsMutex;
-	mutable std::mutex m_informationMutex;
-	mutable std::mutex m_slideStateMutex;
+	mutable std::mutex m_decodedImageCacheSettingsMutex;
+	std::unique_ptr<ContentionTrackingMutex> m_drawablesMutex;
+	mutable std::mutex m_inputLatencyMutex;
+	mutable std::mutex m_startupTimesMutex;
+	mutable std::mutex m_dynamicResolutionMutex;
+	mutable std::mutex m_renderThreadMutex; // guards render thread settings and report
+	mutable std::mutex m_frameTimingsMutex;
+	std::mutex m_traceMutex; // guards trace writer and recording start time
+	std::mutex m_replayEventsMutex;
+	mutable std::mutex m_remoteLoadingProgressMutex;
+	std::mutex m_prepareMutex;
+	std::condition_variable m_prepareCondition;
+	bool m_isPrepareRequested{ false };
+	bool m_isPlayRequested{ false };
+	StartupTimes m_startupTimes;
+	std::atomic<sf::Int64> m_startupRequestTime{ 0 }; // microseconds (steady clock)
+	std::atomic<sf::Int64> m_playRequestTime{ 0 }; // microseconds (steady clock)
+
+	// playback state (shared with the play thread without locking)
+	std::atomic<PlayState> m_playState;
+	std::atomic<SlideState> m_slideState{ SlideState::In };
+	std::atomic<bool> m_moveOnToNextSlide;
+	std::atomic<bool> m_controlSkip;
+	std::atomic<bool> m_controlQuit;
+	std::atomic<bool> m_isWindowHandoffEnabled{ false };
+	std::atomic<unsigned int> m_currentSlideIndex;
+	std::atomic<sf::Int64> m_slideStartTime; // microseconds (steady clock)
 
 	void t_play();
-
+	void t_exchangeWithHost();
+
+	void priv_endPlay(PlayState playState);
+	void priv_gatherDrawables(const CompactSlide& slide, std::vector<const OrderedDrawable*>& drawables); // requires m_drawablesMutex
+	void priv_applyLoadingProgressBindings(float ratio);
+	DrawableInteraction& priv_getDrawableInteraction(const std::string& id); // requires m_drawablesMutex. adds one if needed
+	void priv_markDrawableChanged(const std::string& id); // requires m_drawablesMutex
+	void priv_addDrawable(const std::string& id, OrderedDrawable&& drawable);
+	MemoryReport priv_calculateMemoryReport() const; // requires m_drawablesMutex and resource lock
+	bool priv_fitWithinMemoryBudget(std::size_t newBytes); // requires m_drawablesMutex and resource lock. makes room for a resource of this (estimated) size before it is loaded. false if refused
+	void priv_cancelPreparedThread();
 	void priv_waitForThreadToFinish();
 	SlideState priv_getSlideState() const;
 	void priv_setSlideState(SlideState slideState);
-	bool priv_processKey(std::pair<sf::Keyboard::Key, ControlAction> control, sf::Keyboard::Key key, bool& foundKey);
-	bool priv_processMouseButton(std::pair<ControlAction, MouseButtons> control, sf::Mouse::Button mouseButton, bool& foundMouseButton);
+	void priv_takePlayWindowSettings();
+	void priv_startPlayThread();
+	static CompactSlide priv_compactSlide(Slide&& slide, InternedSlideControls& internedSlideControls);
+	static std::shared_ptr<const SlideControls> priv_internSlideControls(const SlideControls& slideControls, InternedSlideControls& internedSlideControls);
+	static void priv_compileControls(SlideControls& slideControls);
+	static ControlAction priv_getCompiledKeyControlAction(const SlideControls& slideControls, sf::Keyboard::Key key);
+	static ControlAction priv_getCompiledMouseButtonControlAction(const SlideControls& slideControls, sf::Mouse::Button mouseButton);
+	bool priv_processControlAction(ControlAction controlAction, bool& foundControl);
+	void priv_applyRenderThreadSettings(const RenderThreadSettings& settings);
+	std::function<void()> priv_getHelperThreadSetup() const; // applies the niceness and affinity of the render thread settings to the calling thread
+	static void priv_applyThreadScheduling(const RenderThreadSettings& settings, bool& isNicenessApplied, bool& isAffinityApplied); // to the calling thread
+	void priv_recordInputLatency(sf::Time latency);
+	void priv_recordFrameTime(sf::Time frameTime);
+	void priv_next();
+	void priv_recordTrace(TraceRecord& record);
+	void priv_recordEvent(const sf::Event& event);
+	bool priv_popReplayEvent(sf::Event& event);
+	void priv_replayRecord(const TraceRecord& record);
 };
 
 template <class drawableT>
@@ -225,8 +600,7 @@ void Splashentation::addDrawable(const std::string& id, drawableT& drawable, con
 	// ID must be supplied
 	assert(id != "");
 
-	std::lock_guard<std::mutex> lockGuard(m_drawablesMutex);
-	m_drawables.emplace(id, OrderedDrawable(drawable, zIndex));
+	priv_addDrawable(id, OrderedDrawable(drawable, zIndex));
 }
 
 #endif // SPLASHENTATION_STANDARD_HPP
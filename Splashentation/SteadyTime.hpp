@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef SPLASHENTATION_STEADYTIME_HPP
+#define SPLASHENTATION_STEADYTIME_HPP
+
+#include <SFML/Config.hpp>
+
+#include <chrono>
+
+// shared by the library's source files (not part of the interface)
+namespace SplashentationInternal
+{
+
+inline sf::Int64 getSteadyTimeInMicroseconds()
+{
+	return static_cast<sf::Int64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace SplashentationInternal
+
+#endif // SPLASHENTATION_STEADYTIME_HPP
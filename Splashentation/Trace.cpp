@@ -0,0 +1,270 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "Trace.hpp"
+
+#include <cstring> // for std::memcpy and std::memcmp
+#include <algorithm> // for std::max
+
+namespace
+{
+
+const char traceMagic[4]{ 'S', 'P', 'T', 'R' };
+const sf::Uint8 traceVersion{ 3u }; // 2 adds mouse positions. 3 adds play markers
+
+} // namespace
+
+bool Splashentation::TraceWriter::open(const std::string& filename)
+{
+	m_file.open(filename, std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open())
+		return false;
+
+	return open(m_file);
+}
+
+bool Splashentation::TraceWriter::open(std::ostream& stream)
+{
+	m_stream = &stream;
+	m_previousTime = 0;
+	m_ids.clear();
+	m_stream->write(traceMagic, sizeof(traceMagic));
+	m_stream->put(static_cast<char>(traceVersion));
+	return m_stream->good();
+}
+
+void Splashentation::TraceWriter::write(const TraceRecord& record)
+{
+	priv_writeVarint(static_cast<sf::Uint64>(std::max(record.time - m_previousTime, sf::Int64(0))));
+	m_previousTime = std::max(record.time, m_previousTime);
+	m_stream->put(static_cast<char>(record.type));
+
+	if (record.hasId())
+	{
+		const std::unordered_map<std::string, sf::Uint64>::const_iterator id{ m_ids.find(record.id) };
+		if (id != m_ids.end())
+			priv_writeVarint(id->second);
+		else
+		{
+			const sf::Uint64 index{ m_ids.size() };
+			m_ids.emplace(record.id, index);
+			priv_writeVarint(index);
+			priv_writeString(record.id);
+		}
+	}
+
+	switch (record.type)
+	{
+	case TraceRecord::Type::SetDrawableZIndex:
+	case TraceRecord::Type::KeyPressed:
+		priv_writeInteger(record.integer);
+		break;
+	case TraceRecord::Type::MouseButtonPressed:
+		priv_writeInteger(record.integer);
+		priv_writeFloat(record.vector.x);
+		priv_writeFloat(record.vector.y);
+		break;
+	case TraceRecord::Type::SetDrawableScale:
+	case TraceRecord::Type::SetDrawablePosition:
+	case TraceRecord::Type::SetDrawableOrigin:
+	case TraceRecord::Type::MouseMoved:
+		priv_writeFloat(record.vector.x);
+		priv_writeFloat(record.vector.y);
+		break;
+	case TraceRecord::Type::SetDrawableRotation:
+		priv_writeFloat(record.value);
+		break;
+	case TraceRecord::Type::SetDrawableString:
+		priv_writeString(record.string);
+		break;
+	case TraceRecord::Type::LoadingProgress:
+		priv_writeFloat(record.value);
+		priv_writeInteger(record.integer);
+		break;
+	default:
+		break;
+	}
+}
+
+void Splashentation::TraceWriter::close()
+{
+	m_file.close();
+}
+
+void Splashentation::TraceWriter::priv_writeVarint(sf::Uint64 value)
+{
+	while (value >= 0x80u)
+	{
+		m_stream->put(static_cast<char>((value & 0x7Fu) | 0x80u));
+		value >>= 7u;
+	}
+	m_stream->put(static_cast<char>(value));
+}
+
+void Splashentation::TraceWriter::priv_writeInteger(const sf::Int32 value)
+{
+	const sf::Uint32 zigzag{ (static_cast<sf::Uint32>(value) << 1u) ^ ((value < 0) ? 0xFFFFFFFFu : 0u) };
+	priv_writeVarint(zigzag);
+}
+
+void Splashentation::TraceWriter::priv_writeFloat(const float value)
+{
+	sf::Uint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	for (unsigned int i{ 0u }; i < 4u; ++i)
+		m_stream->put(static_cast<char>((bits >> (i * 8u)) & 0xFFu));
+}
+
+void Splashentation::TraceWriter::priv_writeString(const std::string& string)
+{
+	priv_writeVarint(string.size());
+	m_stream->write(string.data(), string.size());
+}
+
+bool Splashentation::TraceReader::open(const std::string& filename)
+{
+	m_file.open(filename, std::ios::binary);
+	if (!m_file.is_open())
+		return false;
+
+	return open(m_file);
+}
+
+bool Splashentation::TraceReader::open(std::istream& stream)
+{
+	m_stream = &stream;
+	m_time = 0;
+	m_ids.clear();
+	char magic[sizeof(traceMagic)];
+	m_stream->read(magic, sizeof(magic));
+	const int version{ m_stream->get() };
+	return (m_stream->good()) && (std::memcmp(magic, traceMagic, sizeof(traceMagic)) == 0) && (version == traceVersion);
+}
+
+bool Splashentation::TraceReader::read(TraceRecord& record)
+{
+	sf::Uint64 timeDelta;
+	if (!priv_readVarint(timeDelta))
+		return false;
+	const int type{ m_stream->get() };
+	if ((type < 0) || (type > static_cast<int>(TraceRecord::Type::Play)))
+		return false;
+
+	record = TraceRecord(static_cast<TraceRecord::Type>(type));
+	m_time += static_cast<sf::Int64>(timeDelta);
+	record.time = m_time;
+
+	if (record.hasId())
+	{
+		sf::Uint64 index;
+		if (!priv_readVarint(index) || (index > m_ids.size()))
+			return false;
+		if (index == m_ids.size())
+		{
+			std::string id;
+			if (!priv_readString(id))
+				return false;
+			m_ids.push_back(id);
+		}
+		record.id = m_ids[static_cast<std::size_t>(index)];
+	}
+
+	switch (record.type)
+	{
+	case TraceRecord::Type::SetDrawableZIndex:
+	case TraceRecord::Type::KeyPressed:
+		return priv_readInteger(record.integer);
+	case TraceRecord::Type::MouseButtonPressed:
+		return priv_readInteger(record.integer) && priv_readFloat(record.vector.x) && priv_readFloat(record.vector.y);
+	case TraceRecord::Type::SetDrawableScale:
+	case TraceRecord::Type::SetDrawablePosition:
+	case TraceRecord::Type::SetDrawableOrigin:
+	case TraceRecord::Type::MouseMoved:
+		return priv_readFloat(record.vector.x) && priv_readFloat(record.vector.y);
+	case TraceRecord::Type::SetDrawableRotation:
+		return priv_readFloat(record.value);
+	case TraceRecord::Type::SetDrawableString:
+		return priv_readString(record.string);
+	case TraceRecord::Type::LoadingProgress:
+		return priv_readFloat(record.value) && priv_readInteger(record.integer);
+	default:
+		return true;
+	}
+}
+
+bool Splashentation::TraceReader::priv_readVarint(sf::Uint64& value)
+{
+	value = 0u;
+	for (unsigned int shift{ 0u }; shift < 64u; shift += 7u)
+	{
+		const int byte{ m_stream->get() };
+		if (byte < 0)
+			return false;
+		value |= static_cast<sf::Uint64>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+bool Splashentation::TraceReader::priv_readInteger(sf::Int32& value)
+{
+	sf::Uint64 zigzag;
+	if (!priv_readVarint(zigzag))
+		return false;
+	value = static_cast<sf::Int32>(static_cast<sf::Uint32>(zigzag >> 1u) ^ ((zigzag & 1u) ? 0xFFFFFFFFu : 0u));
+	return true;
+}
+
+bool Splashentation::TraceReader::priv_readFloat(float& value)
+{
+	sf::Uint32 bits{ 0u };
+	for (unsigned int i{ 0u }; i < 4u; ++i)
+	{
+		const int byte{ m_stream->get() };
+		if (byte < 0)
+			return false;
+		bits |= static_cast<sf::Uint32>(byte) << (i * 8u);
+	}
+	std::memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+
+bool Splashentation::TraceReader::priv_readString(std::string& string)
+{
+	sf::Uint64 length;
+	if (!priv_readVarint(length) || (length > 0x1000000u)) // 16MB limit guards against damaged traces
+		return false;
+	string.resize(static_cast<std::size_t>(length));
+	if (length > 0u)
+		m_stream->read(&string[0], static_cast<std::streamsize>(length));
+	return m_stream->good();
+}
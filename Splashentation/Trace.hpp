@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Splashentation (https://github.com/Hapaxia/Splashentation)
+//
+// Copyright (c) 2016-2017 M.J.Silk
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgement in the product documentation would be
+// appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// M.J.Silk
+// MJSilk2@gmail.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef SPLASHENTATION_TRACE_HPP
+#define SPLASHENTATION_TRACE_HPP
+
+#include "Standard.hpp"
+
+#include <fstream>
+
+// binary trace format: "SPTR", version byte, then records of
+// [time since previous record (varint, microseconds)] [type (byte)] [payload].
+// drawable ids are written as an index (varint) into the ids seen so far and, the first time, followed by the id itself.
+// integers are zigzag varints, floats are 4 bytes (little-endian) and strings are a length (varint) followed by their bytes
+
+struct Splashentation::TraceRecord
+{
+	enum class Type : sf::Uint8
+	{
+		End,
+		SetDrawableZIndex,
+		SetDrawableScale,
+		SetDrawablePosition,
+		SetDrawableOrigin,
+		SetDrawableRotation,
+		SetDrawableString,
+		Next,
+		Skip,
+		Quit,
+		KeyPressed,
+		MouseButtonPressed,
+		Closed,
+		LoadingProgress, // only sent to a remote host
+		MouseMoved,
+		Play, // play() was called (replay times are relative to it)
+	};
+
+	Type type;
+	sf::Int64 time; // microseconds since recording started
+	std::string id;
+	sf::Int32 integer; // z index, key code, mouse button or (loading progress) whether complete
+	float value; // rotation or loading progress ratio
+	sf::Vector2f vector; // scale, position, origin or (mouse events) mouse position in pixels
+	std::string string;
+
+	explicit TraceRecord(const Type newType = Type::End, const std::string& newId = "") : type(newType), time(0), id(newId), integer(0), value(0.f), vector(), string() { }
+	bool hasId() const { return (type >= Type::SetDrawableZIndex) && (type <= Type::SetDrawableString); }
+	bool isInput() const { return ((type >= Type::KeyPressed) && (type <= Type::Closed)) || (type == Type::MouseMoved); }
+};
+
+class Splashentation::TraceWriter
+{
+public:
+	bool open(const std::string& filename);
+	bool open(std::ostream& stream);
+	void write(const TraceRecord& record); // records must be written in time order
+	void close();
+
+private:
+	std::ofstream m_file;
+	std::ostream* m_stream{ nullptr };
+	sf::Int64 m_previousTime;
+	std::unordered_map<std::string, sf::Uint64> m_ids;
+
+	void priv_writeVarint(sf::Uint64 value);
+	void priv_writeInteger(sf::Int32 value);
+	void priv_writeFloat(float value);
+	void priv_writeString(const std::string& string);
+};
+
+class Splashentation::TraceReader
+{
+public:
+	bool open(const std::string& filename);
+	bool open(std::istream& stream);
+	bool read(TraceRecord& record); // false at the end of the trace (or if it is damaged)
+
+private:
+	std::ifstream m_file;
+	std::istream* m_stream{ nullptr };
+	sf::Int64 m_time;
+	std::vector<std::string> m_ids;
+
+	bool priv_readVarint(sf::Uint64& value);
+	bool priv_readInteger(sf::Int32& value);
+	bool priv_readFloat(float& value);
+	bool priv_readString(std::string& string);
+};
+
+#endif // SPLASHENTATION_TRACE_HPP
@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Splashentation - "Remote Loading Splash" *EXAMPLE*
+//
+//  by Hapaxia (https://github.com/Hapaxia)
+//
+//
+//  An application that loads while its splash screen is played by another process
+//    (the "Remote Splash Host" example, which must be running).
+//  Progress and the move to the final slide are sent to the host through shared memory.
+//
+//
+//  Please note that this example makes use of C++11 features
+//    and also requires the SFML library (http://www.sfml-dev.org)
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <SFML/Graphics.hpp>
+#include <Splashentation.hpp>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+int main()
+{
+	srand(0);
+
+	// prepare vector of filenames to load (from a choice of 2)
+	std::vector<std::string> filenames;
+	for (unsigned int i{ 0u }; i < 100; ++i)
+		filenames.emplace_back((rand() % 2 == 0) ? "resources/images/sfml-logo-small.png" : "resources/images/The Sun.jpg");
+
+	// connect to the host (which has the window and all of the drawables)
+	Splashentation loadingSplash;
+	if (!loadingSplash.connectToHost("splashentation-example"))
+	{
+		std::cerr << "Remote Splash Host is not running." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// load files, sending progress to the host
+	for (std::size_t f{ 0u }; f < filenames.size(); ++f)
+	{
+		// update progress bar
+		const float ratio{ static_cast<float>(f) / filenames.size() };
+		loadingSplash.setDrawableScale("progress bar", { ratio, 1.f });
+		loadingSplash.setDrawableString("progress text", "PROGRESS: " + std::to_string(static_cast<unsigned int>(std::ceil(ratio * 100.f))) + "%");
+
+		// quitting the host (or the host going away) leaves the loop immediately
+		if (!loadingSplash.isConnectedToHost())
+			break;
+
+		// load file 1000 times to slow down the process and simulate a larger file
+		for (unsigned int i{ 0u }; i < 1000; ++i)
+		{
+			std::ifstream file(filenames[f], std::ios::in | std::ios::binary);
+			std::vector<char> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+		}
+	}
+
+	// progress the host's splashentation to its end since all files have completed
+	if (loadingSplash.isConnectedToHost())
+	{
+		loadingSplash.setDrawableScale("progress bar", { 1.f, 1.f });
+		loadingSplash.setDrawableString("progress text", "PROGRESS: 100%");
+		loadingSplash.next();
+	}
+	loadingSplash.disconnectFromHost();
+
+
+
+	// ...
+	// main application here
+	// ...
+
+
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Splashentation - "Remote Splash Host" *EXAMPLE*
+//
+//  by Hapaxia (https://github.com/Hapaxia)
+//
+//
+//  A loading splash screen played by its own process.
+//  Run this first and then run the "Remote Loading Splash" example, which does the loading
+//    and drives this presentation through shared memory.
+//
+//
+//    Controls:
+//
+//  Escape key          Quit
+//
+//
+//  Please note that this example makes use of C++11 features
+//    and also requires the SFML library (http://www.sfml-dev.org)
+//
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <SFML/Graphics.hpp>
+#include <Splashentation.hpp>
+
+int main()
+{
+	// size of window for loading splash screen
+	const sf::Vector2u loadingSplashWindowSize{ 800u, 600u };
+
+	// set up splashentation
+	Splashentation loadingSplash;
+	loadingSplash.loadFont("arial", "resources/fonts/arial.ttf");
+	loadingSplash.loadTexture("sun photo", "resources/images/The Sun.jpg");
+	loadingSplash.setupWindow(sf::VideoMode(loadingSplashWindowSize.x, loadingSplashWindowSize.y), "WINDOW");
+	loadingSplash.addGlobalControlAction(Splashentation::ControlAction::Quit, sf::Keyboard::Key::Escape);
+
+	// prepare drawables (the application refers to them by their IDs)
+	sf::Text progressText;
+	sf::RectangleShape progressBar;
+	sf::RectangleShape progressBarOutline;
+	progressText.setFont(*loadingSplash.getFont("arial"));
+	progressText.setPosition({ loadingSplashWindowSize.x / 2.f, 500.f });
+	progressText.setString("PROGRESS: 100%");
+	progressText.setOrigin({ progressText.getLocalBounds().left + progressText.getLocalBounds().width / 2.f, progressText.getLocalBounds().top + progressText.getLocalBounds().height / 2.f });
+	progressText.setString("WAITING");
+	progressBar.setSize({ 400.f, 50.f });
+	progressBar.setOrigin({ 0.f, progressBar.getSize().y / 2.f });
+	progressBar.setPosition({ (loadingSplashWindowSize.x - progressBar.getSize().x) / 2.f, 500.f });
+	progressBarOutline = progressBar;
+	progressBar.setFillColor(sf::Color::Blue);
+	progressBar.setScale({ 0.f, 1.f });
+	progressBarOutline.setFillColor(sf::Color(0, 0, 128, 128));
+	progressBarOutline.setOutlineColor(sf::Color::White);
+	progressBarOutline.setOutlineThickness(5.f);
+	sf::RectangleShape sunPhotoSprite;
+	sunPhotoSprite.setTexture(loadingSplash.getTexture("sun photo"));
+	sunPhotoSprite.setSize(sf::Vector2f(loadingSplashWindowSize));
+
+	// add drawables to splashentation
+	loadingSplash.addDrawable("progress bar", progressBar);
+	loadingSplash.addDrawable("progress bar outline", progressBarOutline);
+	loadingSplash.addDrawable("progress text", progressText);
+	loadingSplash.addDrawable("sun photo", sunPhotoSprite);
+
+	// prepare loading slide (no timer; the application moves it on)
+	Splashentation::Slide loadingSlide;
+	loadingSlide.add("sun photo");
+	loadingSlide.add("progress bar");
+	loadingSlide.add("progress bar outline");
+	loadingSlide.add("progress text");
+	loadingSlide.duration = sf::Time::Zero;
+
+	// prepare empty slide to allow final transition
+	Splashentation::Slide finalSlide;
+	finalSlide.duration = sf::seconds(0.0001f);
+	finalSlide.transition = sf::seconds(0.5f); // quick fade out
+
+	// add slides to splashentation (slides are moved in)
+	loadingSplash.addSlide(std::move(loadingSlide));
+	loadingSplash.addSlide(std::move(finalSlide));
+
+	// create the channel for the application and play splashentation
+	if (!loadingSplash.hostRemote("splashentation-example"))
+		return EXIT_FAILURE;
+	loadingSplash.play();
+
+	// wait for the presentation to finish (or be quit)
+	while (loadingSplash.isPlaying())
+		sf::sleep(sf::seconds(0.1f));
+
+	return EXIT_SUCCESS;
+}
@@ -55,11 +55,13 @@ int main()
 
 	// set up splashentation
 	Splashentation loadingSplash;
+	loadingSplash.setupWindow(sf::VideoMode(loadingSplashWindowSize.x, loadingSplashWindowSize.y), "WINDOW");
+	loadingSplash.prepare(); // start the render thread (and create its targets) while the resources load and the rest is set up
 	loadingSplash.loadFont("arial", "resources/fonts/arial.ttf");
 	loadingSplash.loadTexture("sfml logo", "resources/images/sfml-logo-small.png");
 	loadingSplash.loadTexture("sun photo", "resources/images/The Sun.jpg");
-	loadingSplash.setupWindow(sf::VideoMode(loadingSplashWindowSize.x, loadingSplashWindowSize.y), "WINDOW");
 	loadingSplash.addGlobalControlAction(Splashentation::ControlAction::Quit, sf::Keyboard::Key::Escape);
+	loadingSplash.setWindowHandoff(true); // keep the window at the end to use as the main application's window
 
 	// prepare drawables
 	sf::Text progressText;
@@ -92,27 +94,29 @@ int main()
 	loadingSplash.addDrawable("sfml logo", sfmlLogoSprite);
 	loadingSplash.addDrawable("sun photo", sunPhotoSprite);
 
-	// prepare single slide
-	Splashentation::Slide slide;
-	slide.add("sun photo");
-	slide.add("progress bar");
-	slide.add("progress bar outline");
-	slide.add("progress text");
-
-	// add first slide to splashentation
-	slide.duration = sf::seconds(1.f);
-	loadingSplash.addSlide(slide);
-
-	// add second slide to presentation
-	slide.duration = sf::Time::Zero; // no timer
-	slide.add("sfml logo");
-	loadingSplash.addSlide(slide);
-
-	// add empty slide to allow final transition
-	slide.clear();
-	slide.duration = sf::seconds(0.0001f);
-	slide.transition = sf::seconds(0.5f); // quick fade out
-	loadingSplash.addSlide(slide);
+	// prepare first slide
+	Splashentation::Slide firstSlide;
+	firstSlide.add("sun photo");
+	firstSlide.add("progress bar");
+	firstSlide.add("progress bar outline");
+	firstSlide.add("progress text");
+	firstSlide.duration = sf::seconds(1.f);
+
+	// prepare second slide (first slide with sfml logo added)
+	Splashentation::Slide secondSlide;
+	secondSlide.ids = firstSlide.ids;
+	secondSlide.add("sfml logo");
+	secondSlide.duration = sf::Time::Zero; // no timer
+
+	// prepare empty slide to allow final transition
+	Splashentation::Slide finalSlide;
+	finalSlide.duration = sf::seconds(0.0001f);
+	finalSlide.transition = sf::seconds(0.5f); // quick fade out
+
+	// add slides to splashentation (slides are moved in)
+	loadingSplash.addSlide(std::move(firstSlide));
+	loadingSplash.addSlide(std::move(secondSlide));
+	loadingSplash.addSlide(std::move(finalSlide));
 
 	// play splashentation
 	loadingSplash.play();
@@ -172,10 +176,15 @@ int main()
 		loadingSplash.next();
 	}
 
+	// take over the splash window (waits for the final transition to complete)
+	std::unique_ptr<sf::RenderWindow> window{ loadingSplash.takeWindow() };
+	if (!window)
+		return EXIT_SUCCESS;
+
 
 
 	// ...
-	// main application here
+	// main application here (using *window)
 	// ...
 
 